@@ -61,6 +61,9 @@ namespace ares {
   }
 
   namespace Constants {
+    //thread clocks count in units where one second of emulated time is equal to Second, whatever the thread's frequency
+    static constexpr u64 Second = (u64)-1 >> 1;
+
     namespace Colorburst {
       static constexpr f64 NTSC = 315.0 / 88.0 * 1'000'000.0;
       static constexpr f64 PAL  = 283.75 * 15'625.0 + 25.0;
@@ -75,6 +78,7 @@ namespace ares {
 #include <ares/types.hpp>
 #include <ares/random.hpp>
 #include <ares/debug/debug.hpp>
+#include <ares/memory/memory.hpp>
 #include <ares/node/node.hpp>
 #include <ares/platform.hpp>
 #include <ares/memory/fixed-allocator.hpp>
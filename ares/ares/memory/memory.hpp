@@ -2,6 +2,9 @@
 
 namespace ares::Memory {
 
+//incremented each time a state is serialized or unserialized; Writable memories stamp their pages with it on write.
+inline u32 generation = 1;
+
 inline auto mirror(u32 address, u32 size) -> u32 {
   if(size == 0) return 0;
   u32 base = 0;
@@ -4,13 +4,20 @@
 
 namespace ares::Memory {
 
+//writes are tracked per page: each page is stamped with the Memory::generation it was last written in,
+//so that serializing into a state that already holds this memory only has to copy the pages written since.
+//references handed out by operator[] count as writes to their page; data(), begin() and end() to every page.
 template<typename T>
 struct Writable {
+  static constexpr u32 PageSize = 4096 / sizeof(T);
+
   ~Writable() { reset(); }
 
   auto reset() -> void {
     delete[] self.data;
+    delete[] self.pages;
     self.data = nullptr;
+    self.pages = nullptr;
     self.size = 0;
     self.mask = 0;
   }
@@ -22,12 +29,17 @@ struct Writable {
     self.mask = bit::round(self.size) - 1;
     self.data = new T[self.mask + 1];
     memory::fill<T>(self.data, self.mask + 1, fill);
+    delete[] self.pages;
+    self.pages = new u32[self.mask / PageSize + 1];
+    memory::fill<u32>(self.pages, self.mask / PageSize + 1, generation);
+    self.touched = generation;
   }
 
   auto fill(T fill = ~0ull) -> void {
     for(u32 address : range(self.size)) {
       self.data[address] = fill;
     }
+    self.touched = generation;
   }
 
   auto load(VFS::File fp) -> void {
@@ -36,6 +48,7 @@ struct Writable {
     for(u32 address = self.size; address <= self.mask; address++) {
       self.data[address] = self.data[mirror(address, self.size)];
     }
+    self.touched = generation;
   }
 
   auto save(VFS::File fp) -> void {
@@ -43,32 +56,49 @@ struct Writable {
   }
 
   explicit operator bool() const { return (bool)self.data; }
-  auto data() -> T* { return self.data; }
+  auto data() -> T* { self.touched = generation; return self.data; }
   auto data() const -> const T* { return self.data; }
   auto size() const -> u32 { return self.size; }
   auto mask() const -> u32 { return self.mask; }
 
-  auto operator[](u32 address) -> T& { return self.data[address & self.mask]; }
+  auto operator[](u32 address) -> T& { touch(address); return self.data[address & self.mask]; }
   auto operator[](u32 address) const -> T { return self.data[address & self.mask]; }
   auto read(u32 address) const -> T { return self.data[address & self.mask]; }
-  auto write(u32 address, T data) -> void { self.data[address & self.mask] = data; }
-  auto program(u32 address, T data) -> void { self.data[address & self.mask] = data; }
+  auto write(u32 address, T data) -> void { touch(address); self.data[address & self.mask] = data; }
+  auto program(u32 address, T data) -> void { touch(address); self.data[address & self.mask] = data; }
 
-  auto begin() -> T* { return &self.data[0]; }
-  auto end() -> T* { return &self.data[self.size]; }
+  auto begin() -> T* { self.touched = generation; return &self.data[0]; }
+  auto end() -> T* { self.touched = generation; return &self.data[self.size]; }
 
   auto begin() const -> const T* { return &self.data[0]; }
   auto end() const -> const T* { return &self.data[self.size]; }
 
   auto serialize(serializer& s) -> void {
-    s(array_span<T>{self.data, self.size});
+    //pages not written since s last held an image of this memory are already in place:
+    u32 base = s.generation();
+    for(u32 offset = 0; offset < self.size; offset += PageSize) {
+      u32 page = offset / PageSize;
+      u32 length = min(PageSize, self.size - offset);
+      if(base && max(self.pages[page], self.touched) <= base) {
+        s.skip(length * sizeof(T));
+        continue;
+      }
+      s(array_span<T>{self.data + offset, length});
+      if(s.reading()) self.pages[page] = generation;
+    }
   }
 
 private:
+  auto touch(u32 address) -> void {
+    self.pages[(address & self.mask) / PageSize] = generation;
+  }
+
   struct {
     T* data = nullptr;
+    u32* pages = nullptr;  //generation each page was last written in
     u32 size = 0;
     u32 mask = 0;
+    u32 touched = 0;       //generation every page was last written in
   } self;
 };
 
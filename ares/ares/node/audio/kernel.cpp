@@ -0,0 +1,218 @@
+//filter kernels used by Stream::flush().
+//a cascade of biquads is a chain of dependent recurrences, so rather than vectorizing across samples,
+//each lane runs one stage, a sample behind the stage before it: every step feeds a new sample into the
+//first lane, while each other lane takes the output of its neighbor from the previous step.
+//the stages are padded at the front with pass-through lanes, so that the last stage lands in the last lane.
+//lanes with no sample to process at the start and end of a block keep their state unchanged, so that
+//the output matches running each stage one sample at a time (unless the compiler fuses multiply-adds).
+//SSE2 runs one channel two stages to a vector; AVX runs two channels, one to each half of a vector.
+
+namespace Kernel {
+
+//calls f(0) .. f(N - 1) with constant indices, so that arrays of vectors indexed by them stay in registers
+template<typename F, u32... I>
+inline auto unroll(F&& f, std::integer_sequence<u32, I...>) -> void {
+  (f(std::integral_constant<u32, I>{}), ...);
+}
+
+template<u32 N, typename F>
+inline auto unroll(F&& f) -> void {
+  unroll(f, std::make_integer_sequence<u32, N>{});
+}
+
+inline auto cascade(Stream::Stage* stages, u32 count, f64* samples, u32 length) -> void {
+  for(u32 n : range(length)) {
+    f64 sample = samples[n];
+    for(u32 s : range(count)) {
+      auto& f = stages[s];
+      f64 out = sample * f.a0 + f.z1;
+      f.z1 = sample * f.a1 + f.z2 - f.b1 * out;
+      f.z2 = sample * f.a2 - f.b2 * out;
+      sample = out;
+    }
+    samples[n] = sample;
+  }
+}
+
+#if defined(ARES_AUDIO_SSE2)
+//V vectors of two lanes each, for up to 2V stages
+template<u32 V>
+inline auto cascade128(Stream::Stage* stages, u32 count, f64* samples, u32 length) -> void {
+  static constexpr u32 Lanes = 2 * V;
+  u32 padding = Lanes - count;
+
+  alignas(16) f64 a0[Lanes], a1[Lanes], a2[Lanes], b1[Lanes], b2[Lanes], z1[Lanes], z2[Lanes], lane[Lanes];
+  for(u32 l : range(Lanes)) {
+    Stream::Stage f;
+    if(l >= padding) f = stages[l - padding];
+    a0[l] = f.a0, a1[l] = f.a1, a2[l] = f.a2, b1[l] = f.b1, b2[l] = f.b2, z1[l] = f.z1, z2[l] = f.z2;
+    lane[l] = l;
+  }
+
+  __m128d A0[V], A1[V], A2[V], B1[V], B2[V], Z1[V], Z2[V], L[V], Y[V], X[V];
+  unroll<V>([&](u32 v) {
+    A0[v] = _mm_load_pd(a0 + 2 * v), A1[v] = _mm_load_pd(a1 + 2 * v), A2[v] = _mm_load_pd(a2 + 2 * v);
+    B1[v] = _mm_load_pd(b1 + 2 * v), B2[v] = _mm_load_pd(b2 + 2 * v);
+    Z1[v] = _mm_load_pd(z1 + 2 * v), Z2[v] = _mm_load_pd(z2 + 2 * v);
+    L[v] = _mm_load_pd(lane + 2 * v);
+    Y[v] = _mm_setzero_pd();
+  });
+
+  for(u32 k = 0; k < length + Lanes - 1; k++) {
+    //(input, Y[0][0]), (Y[0][1], Y[1][0]), ...
+    X[0] = _mm_shuffle_pd(_mm_set_sd(k < length ? samples[k] : 0.0), Y[0], 0b00);
+    unroll<V - 1>([&](u32 v) { X[v + 1] = _mm_shuffle_pd(Y[v], Y[v + 1], 0b01); });
+
+    if(k >= Lanes - 1 && k < length) {
+      unroll<V>([&](u32 v) {
+        auto out = _mm_add_pd(_mm_mul_pd(X[v], A0[v]), Z1[v]);
+        Z1[v] = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(X[v], A1[v]), Z2[v]), _mm_mul_pd(B1[v], out));
+        Z2[v] = _mm_sub_pd(_mm_mul_pd(X[v], A2[v]), _mm_mul_pd(B2[v], out));
+        Y[v] = out;
+      });
+    } else {
+      //lane l holds sample k - l, which exists when k - length < l <= k
+      auto first = _mm_set1_pd(f64(k) - f64(length));
+      auto last = _mm_set1_pd(f64(k));
+      unroll<V>([&](u32 v) {
+        auto active = _mm_and_pd(_mm_cmpgt_pd(L[v], first), _mm_cmple_pd(L[v], last));
+        auto out = _mm_add_pd(_mm_mul_pd(X[v], A0[v]), Z1[v]);
+        auto n1 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(X[v], A1[v]), Z2[v]), _mm_mul_pd(B1[v], out));
+        auto n2 = _mm_sub_pd(_mm_mul_pd(X[v], A2[v]), _mm_mul_pd(B2[v], out));
+        Z1[v] = _mm_or_pd(_mm_and_pd(active, n1), _mm_andnot_pd(active, Z1[v]));
+        Z2[v] = _mm_or_pd(_mm_and_pd(active, n2), _mm_andnot_pd(active, Z2[v]));
+        Y[v] = out;
+      });
+    }
+
+    if(k >= Lanes - 1) _mm_storeh_pd(samples + k - (Lanes - 1), Y[V - 1]);
+  }
+
+  unroll<V>([&](u32 v) {
+    _mm_store_pd(z1 + 2 * v, Z1[v]);
+    _mm_store_pd(z2 + 2 * v, Z2[v]);
+  });
+  for(u32 l = padding; l < Lanes; l++) {
+    stages[l - padding].z1 = z1[l];
+    stages[l - padding].z2 = z2[l];
+  }
+}
+#endif
+
+#if defined(__AVX__)
+//cascade128<V> for two channels at once: the lower half of each vector runs the first, the upper half the second.
+//_mm256_shuffle_pd() works within each half, so the lanes shift exactly as they do with SSE2.
+template<u32 V>
+inline auto cascade256(Stream::Stage* left, Stream::Stage* right, u32 count, f64* leftSamples, f64* rightSamples, u32 length) -> void {
+  static constexpr u32 Lanes = 2 * V;  //per channel
+  u32 padding = Lanes - count;
+
+  //stage l of channel c is held in element 4 * (l / 2) + 2 * c + l % 2
+  auto element = [](u32 c, u32 l) -> u32 { return 4 * (l >> 1) + 2 * c + (l & 1); };
+  alignas(32) f64 a0[2 * Lanes], a1[2 * Lanes], a2[2 * Lanes], b1[2 * Lanes], b2[2 * Lanes];
+  alignas(32) f64 z1[2 * Lanes], z2[2 * Lanes], lane[2 * Lanes];
+  for(u32 c : range(2)) {
+    for(u32 l : range(Lanes)) {
+      Stream::Stage f;
+      if(l >= padding) f = (c ? right : left)[l - padding];
+      u32 e = element(c, l);
+      a0[e] = f.a0, a1[e] = f.a1, a2[e] = f.a2, b1[e] = f.b1, b2[e] = f.b2, z1[e] = f.z1, z2[e] = f.z2;
+      lane[e] = l;
+    }
+  }
+
+  __m256d A0[V], A1[V], A2[V], B1[V], B2[V], Z1[V], Z2[V], L[V], Y[V], X[V];
+  unroll<V>([&](u32 v) {
+    A0[v] = _mm256_load_pd(a0 + 4 * v), A1[v] = _mm256_load_pd(a1 + 4 * v), A2[v] = _mm256_load_pd(a2 + 4 * v);
+    B1[v] = _mm256_load_pd(b1 + 4 * v), B2[v] = _mm256_load_pd(b2 + 4 * v);
+    Z1[v] = _mm256_load_pd(z1 + 4 * v), Z2[v] = _mm256_load_pd(z2 + 4 * v);
+    L[v] = _mm256_load_pd(lane + 4 * v);
+    Y[v] = _mm256_setzero_pd();
+  });
+
+  for(u32 k = 0; k < length + Lanes - 1; k++) {
+    auto input = k < length ? _mm256_setr_pd(leftSamples[k], 0.0, rightSamples[k], 0.0) : _mm256_setzero_pd();
+    X[0] = _mm256_shuffle_pd(input, Y[0], 0b0000);
+    unroll<V - 1>([&](u32 v) { X[v + 1] = _mm256_shuffle_pd(Y[v], Y[v + 1], 0b0101); });
+
+    if(k >= Lanes - 1 && k < length) {
+      unroll<V>([&](u32 v) {
+        auto out = _mm256_add_pd(_mm256_mul_pd(X[v], A0[v]), Z1[v]);
+        Z1[v] = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(X[v], A1[v]), Z2[v]), _mm256_mul_pd(B1[v], out));
+        Z2[v] = _mm256_sub_pd(_mm256_mul_pd(X[v], A2[v]), _mm256_mul_pd(B2[v], out));
+        Y[v] = out;
+      });
+    } else {
+      auto first = _mm256_set1_pd(f64(k) - f64(length));
+      auto last = _mm256_set1_pd(f64(k));
+      unroll<V>([&](u32 v) {
+        auto active = _mm256_and_pd(_mm256_cmp_pd(L[v], first, _CMP_GT_OQ), _mm256_cmp_pd(L[v], last, _CMP_LE_OQ));
+        auto out = _mm256_add_pd(_mm256_mul_pd(X[v], A0[v]), Z1[v]);
+        auto n1 = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(X[v], A1[v]), Z2[v]), _mm256_mul_pd(B1[v], out));
+        auto n2 = _mm256_sub_pd(_mm256_mul_pd(X[v], A2[v]), _mm256_mul_pd(B2[v], out));
+        Z1[v] = _mm256_blendv_pd(Z1[v], n1, active);
+        Z2[v] = _mm256_blendv_pd(Z2[v], n2, active);
+        Y[v] = out;
+      });
+    }
+
+    if(k >= Lanes - 1) {
+      _mm_storeh_pd(leftSamples + k - (Lanes - 1), _mm256_castpd256_pd128(Y[V - 1]));
+      _mm_storeh_pd(rightSamples + k - (Lanes - 1), _mm256_extractf128_pd(Y[V - 1], 1));
+    }
+  }
+
+  unroll<V>([&](u32 v) {
+    _mm256_store_pd(z1 + 4 * v, Z1[v]);
+    _mm256_store_pd(z2 + 4 * v, Z2[v]);
+  });
+  for(u32 c : range(2)) {
+    for(u32 l = padding; l < Lanes; l++) {
+      auto& f = (c ? right : left)[l - padding];
+      f.z1 = z1[element(c, l)];
+      f.z2 = z2[element(c, l)];
+    }
+  }
+}
+#endif
+
+//runs samples[0 .. length) through each stage in turn, in place.
+//longer cascades are split; each part processes the whole block before the next.
+inline auto filter(Stream::Stage* stages, u32 count, f64* samples, u32 length) -> void {
+  while(count) {
+    u32 part = count;
+    #if defined(ARES_AUDIO_SSE2)
+    if(part > 8) part = 8;
+    if(part <= 1) cascade(stages, part, samples, length);
+    else if(part <= 2) cascade128<1>(stages, part, samples, length);
+    else if(part <= 4) cascade128<2>(stages, part, samples, length);
+    else if(part <= 6) cascade128<3>(stages, part, samples, length);
+    else cascade128<4>(stages, part, samples, length);
+    #else
+    cascade(stages, part, samples, length);
+    #endif
+    stages += part;
+    count -= part;
+  }
+}
+
+//as above, for two channels with the same number of stages
+inline auto filter(Stream::Stage* left, Stream::Stage* right, u32 count, f64* leftSamples, f64* rightSamples, u32 length) -> void {
+  #if defined(__AVX__)
+  while(count) {
+    u32 part = count;
+    if(part > 8) part = 8;
+    if(part <= 2) cascade256<1>(left, right, part, leftSamples, rightSamples, length);
+    else if(part <= 4) cascade256<2>(left, right, part, leftSamples, rightSamples, length);
+    else if(part <= 6) cascade256<3>(left, right, part, leftSamples, rightSamples, length);
+    else cascade256<4>(left, right, part, leftSamples, rightSamples, length);
+    left += part, right += part;
+    count -= part;
+  }
+  #else
+  filter(left, count, leftSamples, length);
+  filter(right, count, rightSamples, length);
+  #endif
+}
+
+}
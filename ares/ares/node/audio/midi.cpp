@@ -1,16 +1,165 @@
-auto MIDI::writeShort(u8 cmd, u8 data1, u8 data2) -> void {
-  _shortMsg = (((s32)data2 << 16) & 0xFF0000) |
-              (((s32)data1 <<  8) &   0xFF00) |
-               ((s32)cmd & 0xFF);
+auto MIDI::setFrequency(f64 frequency) -> void {
+  _frequency = frequency;
+}
+
+//re-anchors the current batch after the owner's thread clock was adjusted from outside.
+//eg the scheduler rebasing all thread clocks, or a state being unserialized.
+auto MIDI::setClock(u64 clock) -> void {
+  _clock = clock;
+}
+
+//follows the owner's thread clock after Scheduler::exit() subtracted reduce from it.
+//the batch may have begun before the new zero point, so _clock is allowed to wrap (see elapsed()).
+auto MIDI::rebase(u64 reduce) -> void {
+  _clock -= reduce;
+}
+
+//names the voices that generate messages, so that sinks may keep them apart (eg as separate MIDI file tracks).
+//track 0 is for messages that do not belong to any one voice.
+auto MIDI::setTracks(const vector<string>& tracks) -> void {
+  _tracks = tracks;
+}
+
+//when enabled, events are no longer delivered at the time they were written, but as soon as the link is free.
+//queued note messages go ahead of queued controller updates, so notes are not delayed by a backlog of pitch bends;
+//but never ahead of those written earlier on their own channel, so that a note sounds with the program and volume
+//set before it. a controller update that is superseded before it was sent is replaced rather than sent twice.
+auto MIDI::setScheduler(bool scheduler) -> void {
+  if(_scheduler && !scheduler) transmit(std::numeric_limits<f64>::infinity());
+  _scheduler = scheduler;
+  _wire = 0.0;
+  _status = 0;
+}
 
-  platform->midi(shared());
+//speculative events are buffered as usual, but frame() discards them rather than delivering them;
+//ending speculation restores the node to the moment speculation began.
+auto MIDI::setSpeculative(bool speculative) -> void {
+  if(_speculative == speculative) return;
+  _speculative = speculative;
+  if(speculative) {
+    _speculation = {_clock, _position, _timestamp, _last, _delay, _wire, _status, _pending, _notes, _controls, _telemetry};
+  } else {
+    _clock = _speculation.clock;
+    _position = _speculation.position;
+    _timestamp = _speculation.timestamp;
+    _last = _speculation.last;
+    _delay = _speculation.delay;
+    _wire = _speculation.wire;
+    _status = _speculation.status;
+    _pending = std::move(_speculation.pending);
+    _notes = std::move(_speculation.notes);
+    _controls = std::move(_speculation.controls);
+    _telemetry = _speculation.telemetry;
+  }
 }
 
+auto MIDI::write(u64 clock, u8 cmd, u8 data1, u8 data2, u8 track) -> void {
+  u64 timestamp = _position + elapsed(clock) + 0.5;
+  //events must never be reordered, and must honor any requested spacing:
+  timestamp = max(timestamp, _last + _delay);
+  _last = timestamp;
+  _delay = 0;
+
+  if(!_scheduler) {
+    u32 message = data2 << 16 | data1 << 8 | cmd << 0;
+    return deliver({timestamp, message, track});
+  }
+
+  //note off is sent as note on with zero velocity, so that it can share running status with note on:
+  if((cmd & 0xf0) == 0x80) cmd = 0x90 | cmd & 0x0f, data2 = 0;
+  u32 message = data2 << 16 | data1 << 8 | cmd << 0;
+
+  u8 type = cmd & 0xf0;
+  if(type == 0xe0 || (type == 0xb0 && data1 < 120)) {
+    for(u32 n : range(_controls.size())) {
+      auto& event = _controls[n];
+      if((u8)event.message != cmd) continue;
+      if(type == 0xb0 && (u8)(event.message >> 8) != data1) continue;
+      //the superseded value is dropped, and the new one queued at its own time:
+      //sending it at the old time would put it ahead of the write, and of notes written since.
+      _controls.remove(n);
+      _telemetry.coalesced++;
+      break;
+    }
+    _controls.append({timestamp, message, track});
+  } else {
+    //the channel's pending controller updates move to the note queue, to be sent ahead of this message:
+    if(type < 0xf0) {
+      for(u32 n = 0; n < _controls.size();) {
+        if(((u8)_controls[n].message ^ cmd) & 0x0f) { n++; continue; }
+        _notes.append(_controls[n]);
+        _controls.remove(n);
+      }
+    }
+    _notes.append({timestamp, message, track});
+  }
+  transmit(timestamp);
+}
+
+//spaces out the next event, for devices that drop messages sent in rapid bursts.
 auto MIDI::delay() -> void {
-  _shortMsg = 0xFFFFFFFF;
-  platform->midi(shared());
+  _delay += _frequency * 0.003 + 0.5;
+}
+
+//ends the current batch at the given clock, and delivers all of its events at once.
+auto MIDI::frame(u64 clock) -> void {
+  _timestamp = _position;
+  _position += elapsed(clock);
+  _clock = clock;
+  if(_scheduler) transmit(_position);
+  if(_speculative) {
+    _pending.resize(0);
+    return;
+  }
+
+  swap(_events, _pending);
+  _pending.resize(0);
+  if(_events) platform->midi(shared());
+}
+
+//sends queued events over the modeled link, up to (but excluding) the given time:
+//an event may only be chosen once every event written before it was sent is known.
+auto MIDI::transmit(f64 until) -> void {
+  while(_notes || _controls) {
+    f64 next = std::numeric_limits<f64>::infinity();
+    if(_notes) next = min(next, (f64)_notes.first().timestamp);
+    if(_controls) next = min(next, (f64)_controls.first().timestamp);
+    f64 slot = max(_wire, next);
+    if(slot >= until) return;
+    if(_notes && _notes.first().timestamp <= slot) {
+      emit(slot, _notes.takeFirst());
+    } else {
+      emit(slot, _controls.takeFirst());
+    }
+  }
+}
+
+//the emulated time (in samples) from the start of the current batch to the given clock
+auto MIDI::elapsed(u64 clock) const -> f64 {
+  s64 clocks = clock - _clock;
+  return clocks > 0 ? clocks * _frequency / Constants::Second : 0.0;
+}
+
+auto MIDI::emit(f64 timestamp, const Event& event) -> void {
+  u8 status = event.message;
+  //program change and channel pressure carry only one data byte:
+  u32 bytes = (status & 0xe0) == 0xc0 ? 2 : 3;
+  //running status: a repeated status byte is not sent again
+  if(status == _status) bytes--;
+  _status = status;
+  _wire = timestamp + bytes * 10 * _frequency / Baud;
+  deliver({u64(timestamp + 0.5), event.message, event.track});
 }
 
-auto MIDI::readShort() -> s32 {
-  return _shortMsg;
+auto MIDI::deliver(const Event& event) -> void {
+  switch(event.message >> 4 & 15) {
+  case 0x8: _telemetry.noteOff++; break;
+  //note on with zero velocity is a note off:
+  case 0x9: event.message >> 16 & 0x7f ? _telemetry.noteOn++ : _telemetry.noteOff++; break;
+  case 0xb: _telemetry.controlChange++; break;
+  case 0xc: _telemetry.programChange++; break;
+  case 0xe: _telemetry.pitchBend++; break;
+  default:  _telemetry.other++; break;
+  }
+  _pending.append(event);
 }
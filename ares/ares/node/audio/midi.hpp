@@ -2,9 +2,96 @@ struct MIDI : Audio {
   DeclareClass(MIDI, "midi")
   using Audio::Audio;
 
-  auto readShort() -> s32;
-  auto writeShort(u8 cmd, u8 data1, u8 data2) -> void;
+  //MIDI 1.0 serial link: 31250 baud, ten bits (start + 8 data + stop) per byte
+  static constexpr u32 Baud = 31250;
+
+  struct Event {
+    u64 timestamp;  //emulated time, in samples at frequency(), since the node was created
+    u32 message;    //status | data1 << 8 | data2 << 16
+    u8  track;      //index into tracks(): the voice that generated the message
+  };
+
+  //cumulative counters since the node was created, cheap enough to poll from the front end at any time.
+  //message counts are of messages delivered by frame(); the remaining counters are kept by the source.
+  struct Telemetry {
+    u64 noteOff = 0;
+    u64 noteOn = 0;
+    u64 controlChange = 0;
+    u64 programChange = 0;
+    u64 pitchBend = 0;
+    u64 other = 0;         //aftertouch and channel pressure
+    u64 dropped = 0;       //redundant messages the source did not send
+    u64 coalesced = 0;     //updates superseded while still queued by the scheduler
+    u64 stalls = 0;        //updates the source deferred to limit its message rate
+    u64 cacheMisses = 0;   //sample lookups that were not cached by the source
+    u64 sampleMisses = 0;  //samples that have no MIDI translation
+
+    auto messages() const -> u64 {
+      return noteOff + noteOn + controlChange + programChange + pitchBend + other;
+    }
+  };
+
+  auto frequency() const -> f64 { return _frequency; }
+  auto tracks() const -> const vector<string>& { return _tracks; }
+  auto timestamp() const -> u64 { return _timestamp; }
+  auto events() const -> const vector<Event>& { return _events; }
+  auto scheduler() const -> bool { return _scheduler; }
+  auto speculative() const -> bool { return _speculative; }
+  auto telemetry() const -> const Telemetry& { return _telemetry; }
+  auto telemetry() -> Telemetry& { return _telemetry; }
+
+  //clock values passed to setClock(), rebase(), write() and frame() are thread clock values,
+  //where one second is equal to Constants::Second (as with Thread::Second)
+  auto setFrequency(f64 frequency) -> void;
+  auto setClock(u64 clock) -> void;
+  auto rebase(u64 reduce) -> void;
+  auto setTracks(const vector<string>& tracks) -> void;
+  auto setScheduler(bool scheduler) -> void;
+  auto setSpeculative(bool speculative) -> void;
+
+  auto write(u64 clock, u8 cmd, u8 data1, u8 data2, u8 track = 0) -> void;
   auto delay() -> void;
+  auto frame(u64 clock) -> void;
+
 protected:
-  s32 _shortMsg;
+  auto transmit(f64 until) -> void;
+  auto elapsed(u64 clock) const -> f64;
+  auto emit(f64 timestamp, const Event& event) -> void;
+  auto deliver(const Event& event) -> void;
+
+  f64 _frequency = 48000.0;
+  vector<string> _tracks = {"MIDI"};
+  u64 _clock = 0;          //thread clock at the start of the current batch
+  f64 _position = 0.0;     //emulated time (in samples) at the start of the current batch
+  u64 _timestamp = 0;      //emulated time (in samples) at the start of the delivered batch
+  u64 _last = 0;           //timestamp of the most recently written event
+  u64 _delay = 0;          //minimum spacing (in samples) before the next event
+  vector<Event> _pending;  //events written during the current batch
+  vector<Event> _events;   //events delivered by the most recent frame()
+  Telemetry _telemetry;
+
+  //run-ahead: a speculative frame is rolled back once it has been shown, but sent messages cannot be taken back.
+  //so nothing is delivered while speculative, and the node returns to where it was when speculation began.
+  bool _speculative = false;
+  struct Speculation {
+    u64 clock;
+    f64 position;
+    u64 timestamp;
+    u64 last;
+    u64 delay;
+    f64 wire;
+    u8 status;
+    vector<Event> pending;
+    vector<Event> notes;
+    vector<Event> controls;
+    Telemetry telemetry;
+  } _speculation;
+
+  //wire scheduler: events are queued with the time they were written, and leave the queues
+  //no faster than a 31250 baud link could carry them.
+  bool _scheduler = false;
+  f64 _wire = 0.0;         //emulated time (in samples) at which the link is next idle
+  u8 _status = 0;          //running status: the last status byte sent over the link
+  vector<Event> _notes;    //note on/off, program change and channel mode messages, and the updates they follow
+  vector<Event> _controls; //pitch bend and controller updates; superseded values are coalesced
 };
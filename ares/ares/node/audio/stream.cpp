@@ -1,18 +1,24 @@
 auto Stream::setChannels(u32 channels) -> void {
   _channels.reset();
   _channels.resize(channels);
+  _buffered = 0;
 }
 
 auto Stream::setFrequency(f64 frequency) -> void {
+  flush();
   _frequency = frequency;
+  //buffer no more than 0.25ms, so that streams are still mixed promptly
+  _blockSize = max(1u, min(BlockSize, u32(_frequency / 4000.0)));
   setResamplerFrequency(_resamplerFrequency);
 }
 
 auto Stream::setResamplerFrequency(f64 resamplerFrequency) -> void {
+  flush();
   _resamplerFrequency = resamplerFrequency;
 
   for(auto& channel : _channels) {
-    channel.nyquist.reset();
+    channel.stages.removeRight(channel.nyquist);
+    channel.nyquist = 0;
     channel.resampler.reset(_frequency, _resamplerFrequency);
   }
 
@@ -25,7 +31,8 @@ auto Stream::setResamplerFrequency(f64 resamplerFrequency) -> void {
         DSP::IIR::Biquad filter;
         f64 q = DSP::IIR::Biquad::butterworth(passes * 2, pass);
         filter.reset(DSP::IIR::Biquad::Type::LowPass, cutoffFrequency, _frequency, q);
-        channel.nyquist.append(filter);
+        channel.stages.append(stage(filter));
+        channel.nyquist++;
       }
     }
   }
@@ -36,65 +43,70 @@ auto Stream::setMuted(bool muted) -> void {
 }
 
 auto Stream::resetFilters() -> void {
+  flush();
   for(auto& channel : _channels) {
-    channel.filters.reset();
+    channel.stages.removeLeft(channel.stages.size() - channel.nyquist);
   }
 }
 
 auto Stream::addLowPassFilter(f64 cutoffFrequency, u32 order, u32 passes) -> void {
+  flush();
   for(auto& channel : _channels) {
     for(u32 pass : range(passes)) {
       if(order == 1) {
-        Filter filter{Filter::Mode::OnePole, Filter::Type::LowPass, Filter::Order::First};
-        filter.onePole.reset(DSP::IIR::OnePole::Type::LowPass, cutoffFrequency, _frequency);
-        channel.filters.append(filter);
+        DSP::IIR::OnePole filter;
+        filter.reset(DSP::IIR::OnePole::Type::LowPass, cutoffFrequency, _frequency);
+        channel.addFilter(stage(filter));
       }
       if(order == 2) {
-        Filter filter{Filter::Mode::Biquad, Filter::Type::LowPass, Filter::Order::Second};
+        DSP::IIR::Biquad filter;
         f64 q = DSP::IIR::Biquad::butterworth(passes * 2, pass);
-        filter.biquad.reset(DSP::IIR::Biquad::Type::LowPass, cutoffFrequency, _frequency, q);
-        channel.filters.append(filter);
+        filter.reset(DSP::IIR::Biquad::Type::LowPass, cutoffFrequency, _frequency, q);
+        channel.addFilter(stage(filter));
       }
     }
   }
 }
 
 auto Stream::addHighPassFilter(f64 cutoffFrequency, u32 order, u32 passes) -> void {
+  flush();
   for(auto& channel : _channels) {
     for(u32 pass : range(passes)) {
       if(order == 1) {
-        Filter filter{Filter::Mode::OnePole, Filter::Type::HighPass, Filter::Order::First};
-        filter.onePole.reset(DSP::IIR::OnePole::Type::HighPass, cutoffFrequency, _frequency);
-        channel.filters.append(filter);
+        DSP::IIR::OnePole filter;
+        filter.reset(DSP::IIR::OnePole::Type::HighPass, cutoffFrequency, _frequency);
+        channel.addFilter(stage(filter));
       }
       if(order == 2) {
-        Filter filter{Filter::Mode::Biquad, Filter::Type::HighPass, Filter::Order::Second};
+        DSP::IIR::Biquad filter;
         f64 q = DSP::IIR::Biquad::butterworth(passes * 2, pass);
-        filter.biquad.reset(DSP::IIR::Biquad::Type::HighPass, cutoffFrequency, _frequency, q);
-        channel.filters.append(filter);
+        filter.reset(DSP::IIR::Biquad::Type::HighPass, cutoffFrequency, _frequency, q);
+        channel.addFilter(stage(filter));
       }
     }
   }
 }
 
 auto Stream::addLowShelfFilter(f64 cutoffFrequency, u32 order, f64 gain, f64 slope) -> void {
+  flush();
   for(auto& channel : _channels) {
     if(order == 2) {
-      Filter filter{Filter::Mode::Biquad, Filter::Type::LowShelf, Filter::Order::Second};
+      DSP::IIR::Biquad filter;
       f64 q = DSP::IIR::Biquad::shelf(gain, slope);
-      filter.biquad.reset(DSP::IIR::Biquad::Type::LowShelf, cutoffFrequency, _frequency, q);
-      channel.filters.append(filter);
+      filter.reset(DSP::IIR::Biquad::Type::LowShelf, cutoffFrequency, _frequency, q);
+      channel.addFilter(stage(filter));
     }
   }
 }
 
 auto Stream::addHighShelfFilter(f64 cutoffFrequency, u32 order, f64 gain, f64 slope) -> void {
+  flush();
   for(auto& channel : _channels) {
     if(order == 2) {
-      Filter filter{Filter::Mode::Biquad, Filter::Type::HighShelf, Filter::Order::Second};
+      DSP::IIR::Biquad filter;
       f64 q = DSP::IIR::Biquad::shelf(gain, slope);
-      filter.biquad.reset(DSP::IIR::Biquad::Type::HighShelf, cutoffFrequency, _frequency, q);
-      channel.filters.append(filter);
+      filter.reset(DSP::IIR::Biquad::Type::HighShelf, cutoffFrequency, _frequency, q);
+      channel.addFilter(stage(filter));
     }
   }
 }
@@ -112,20 +124,58 @@ auto Stream::read(f64 samples[]) -> u32 {
 
 auto Stream::write(const f64 samples[]) -> void {
   for(u32 c : range(_channels.size())) {
-    f64 sample = samples[c] + 1e-25;  //constant offset used to suppress denormals
-    for(auto& filter : _channels[c].filters) {
-      switch(filter.mode) {
-      case Filter::Mode::OnePole: sample = filter.onePole.process(sample); break;
-      case Filter::Mode::Biquad: sample = filter.biquad.process(sample); break;
-      }
-    }
-    for(auto& filter : _channels[c].nyquist) {
-      sample = filter.process(sample);
+    _channels[c].buffer[_buffered] = samples[c] + 1e-25;  //constant offset used to suppress denormals
+  }
+  if(++_buffered >= _blockSize) flush();
+}
+
+auto Stream::write(array_view<f64> samples) -> void {
+  u32 channels = _channels.size();
+  if(!channels) return;
+  for(u32 offset = 0; offset + channels <= samples.size(); offset += channels) {
+    for(u32 c : range(channels)) {
+      _channels[c].buffer[_buffered] = samples[offset + c] + 1e-25;
     }
-    _channels[c].resampler.write(sample);
+    if(++_buffered >= _blockSize) flush();
+  }
+}
+
+//filters and resamples the buffered samples
+auto Stream::flush() -> void {
+  if(!_buffered) return;
+  u32 c = 0;
+  for(; c + 2 <= _channels.size(); c += 2) {
+    auto& left = _channels[c + 0];
+    auto& right = _channels[c + 1];
+    Kernel::filter(left.stages.data(), right.stages.data(), left.stages.size(), left.buffer, right.buffer, _buffered);
+  }
+  if(c < _channels.size()) {
+    auto& channel = _channels[c];
+    Kernel::filter(channel.stages.data(), channel.stages.size(), channel.buffer, _buffered);
   }
+  for(auto& channel : _channels) {
+    channel.resampler.write({channel.buffer, _buffered});
+  }
+  _buffered = 0;
 
   //if there are samples pending, then alert the frontend to possibly process them.
   //this will generally happen when every audio stream has pending samples to be mixed.
   if(pending()) platform->audio(shared());
 }
+
+auto Stream::stage(const DSP::IIR::OnePole& filter) -> Stage {
+  //y[n] = a0 x[n] + b1 y[n-1], with the sign of b1 flipped to match the biquad recurrence
+  auto c = filter.coefficients();
+  return {c.a0, 0.0, 0.0, -c.b1, 0.0};
+}
+
+auto Stream::stage(const DSP::IIR::Biquad& filter) -> Stage {
+  auto c = filter.coefficients();
+  return {c.a0, c.a1, c.a2, c.b1, c.b2};
+}
+
+auto Stream::Channel::addFilter(const Stage& stage) -> void {
+  //keep the anti-aliasing filters last
+  stages.append(stage);
+  for(u32 n : range(nyquist)) swap(stages[stages.size() - 1 - n], stages[stages.size() - 2 - n]);
+}
@@ -21,6 +21,8 @@ struct Stream : Audio {
   auto pending() const -> bool;
   auto read(f64 samples[]) -> u32;
   auto write(const f64 samples[]) -> void;
+  auto write(array_view<f64> samples) -> void;  //interleaved frames
+  auto flush() -> void;
 
   template<typename... P>
   auto frame(P&&... p) -> void {
@@ -29,20 +31,30 @@ struct Stream : Audio {
     write(samples);
   }
 
-protected:
-  struct Filter {
-    enum class Mode : u32 { OnePole, Biquad } mode;
-    enum class Type : u32 { None, LowPass, HighPass, LowShelf, HighShelf } type;
-    enum class Order : u32 { None, First, Second } order;
-    DSP::IIR::OnePole onePole;
-    DSP::IIR::Biquad biquad;
+  //a transposed direct form II biquad; one-pole filters are stored as biquads with a1 = a2 = b2 = 0
+  struct Stage {
+    f64 a0 = 1.0, a1 = 0.0, a2 = 0.0, b1 = 0.0, b2 = 0.0;  //coefficients
+    f64 z1 = 0.0, z2 = 0.0;                                //second-order IIR
   };
+
+  //the most frames buffered before they are filtered and resampled together
+  static constexpr u32 BlockSize = 256;
+
+protected:
+  static auto stage(const DSP::IIR::OnePole& filter) -> Stage;
+  static auto stage(const DSP::IIR::Biquad& filter) -> Stage;
+
   struct Channel {
-    vector<Filter> filters;
-    vector<DSP::IIR::Biquad> nyquist;
+    auto addFilter(const Stage& stage) -> void;
+
+    vector<Stage> stages;  //filters, followed by the anti-aliasing filters
+    u32 nyquist = 0;       //the number of anti-aliasing filters
     DSP::Resampler::Cubic resampler;
+    f64 buffer[BlockSize];
   };
   vector<Channel> _channels;
+  u32 _buffered = 0;
+  u32 _blockSize = 12;
   f64 _frequency = 48000.0;
   f64 _resamplerFrequency = 48000.0;
   bool _muted = false;
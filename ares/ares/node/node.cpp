@@ -1,9 +1,22 @@
+#if defined(ARCHITECTURE_AMD64)
+  #include <immintrin.h>
+  #define ARES_VIDEO_SSE2
+  #define ARES_AUDIO_SSE2
+#elif defined(ARCHITECTURE_ARM64) && !defined(COMPILER_MICROSOFT)
+  #define SSE2NEON_SUPPRESS_WARNINGS
+  #include <sse2neon.h>
+  #define ARES_VIDEO_SSE2
+  #define ARES_AUDIO_SSE2
+#endif
+
 namespace ares::Core {
   namespace Video {
+    #include <ares/node/video/kernel.cpp>
     #include <ares/node/video/sprite.cpp>
     #include <ares/node/video/screen.cpp>
   }
   namespace Audio {
+    #include <ares/node/audio/kernel.cpp>
     #include <ares/node/audio/stream.cpp>
     #include <ares/node/audio/midi.cpp>
   }
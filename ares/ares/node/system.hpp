@@ -7,8 +7,33 @@ struct System : Object {
   auto power(bool reset = false) -> void { if(_power) return _power(reset); }
   auto save() -> void { if(_save) return _save(); }
   auto unload() -> void { if(_unload) return _unload(); }
-  auto serialize(bool synchronize = true) -> serializer { if(_serialize) return _serialize(synchronize); return {}; }
-  auto unserialize(serializer& s) -> bool { if(_unserialize) return _unserialize(s); return false; }
+  auto serialize(bool synchronize = true) -> serializer {
+    serializer s;
+    serialize(s, synchronize);
+    return s;
+  }
+
+  //reusing the same serializer for successive snapshots lets memories skip the pages it already holds.
+  //only cores with a serializeTo() handler opt into this, having checked that every write to their memories
+  //is tracked; other cores always produce, and restore, a complete state.
+  auto serialize(serializer& s, bool synchronize = true) -> void {
+    if(_serializeTo) {
+      s.setWriting();
+      _serializeTo(s, synchronize);
+      s.setGeneration(Memory::generation++);
+    } else if(_serialize) {
+      s = _serialize(synchronize);
+    } else {
+      s = {};
+    }
+  }
+
+  auto unserialize(serializer& s) -> bool {
+    if(!_serializeTo) s.setGeneration(0);
+    if(!_unserialize || !_unserialize(s)) return false;
+    if(_serializeTo) s.setGeneration(Memory::generation++);
+    return true;
+  }
 
   auto setGame(function<string ()> game) -> void { _game = game; }
   auto setRun(function<void ()> run) -> void { _run = run; }
@@ -16,6 +41,7 @@ struct System : Object {
   auto setSave(function<void ()> save) -> void { _save = save; }
   auto setUnload(function<void ()> unload) -> void { _unload = unload; }
   auto setSerialize(function<serializer (bool)> serialize) -> void { _serialize = serialize; }
+  auto setSerializeTo(function<void (serializer&, bool)> serializeTo) -> void { _serializeTo = serializeTo; }
   auto setUnserialize(function<bool (serializer&)> unserialize) -> void { _unserialize = unserialize; }
 
 protected:
@@ -25,5 +51,6 @@ protected:
   function<void ()> _save;
   function<void ()> _unload;
   function<serializer (bool)> _serialize;
+  function<void (serializer&, bool)> _serializeTo;
   function<bool (serializer&)> _unserialize;
 };
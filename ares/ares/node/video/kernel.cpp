@@ -0,0 +1,191 @@
+//pixel kernels used by Screen::refresh().
+//each has a scalar reference version; AVX2 is used when the build targets it, SSE2 on amd64 otherwise,
+//and NEON (by way of sse2neon) on arm64. all versions produce identical output.
+
+namespace Kernel {
+
+//per-channel average of two ARGB8888 colors, rounded down.
+//note: the carry out of the alpha channel is discarded, as it always has been.
+inline auto average(u32 a, u32 b) -> u32 {
+  return (a + b - ((a ^ b) & 0x01010101)) >> 1;
+}
+
+#if defined(ARES_VIDEO_SSE2)
+inline auto average(__m128i a, __m128i b) -> __m128i {
+  auto carry = _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi32(0x01010101));
+  return _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(a, b), carry), 1);
+}
+
+//reverses the order of four pixels.
+inline auto reverse(__m128i a) -> __m128i {
+  return _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+//transposes a 4x4 block of pixels held in four rows.
+inline auto transpose(__m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3) -> void {
+  auto t0 = _mm_unpacklo_epi32(r0, r1);  //00 10 01 11
+  auto t1 = _mm_unpacklo_epi32(r2, r3);  //20 30 21 31
+  auto t2 = _mm_unpackhi_epi32(r0, r1);  //02 12 03 13
+  auto t3 = _mm_unpackhi_epi32(r2, r3);  //22 32 23 33
+  r0 = _mm_unpacklo_epi64(t0, t1);
+  r1 = _mm_unpackhi_epi64(t0, t1);
+  r2 = _mm_unpacklo_epi64(t2, t3);
+  r3 = _mm_unpackhi_epi64(t2, t3);
+}
+#endif
+
+#if defined(__AVX2__)
+inline auto average(__m256i a, __m256i b) -> __m256i {
+  auto carry = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi32(0x01010101));
+  return _mm256_srli_epi32(_mm256_sub_epi32(_mm256_add_epi32(a, b), carry), 1);
+}
+
+inline auto gather(const u32* palette, const u32* source) -> __m256i {
+  auto index = _mm256_loadu_si256((const __m256i*)source);
+  return _mm256_i32gather_epi32((const int*)palette, index, 4);
+}
+#endif
+
+//target[x] = palette[source[x]]
+inline auto convert(u32* target, const u32* source, const u32* palette, u32 length) -> void {
+  u32 x = 0;
+  #if defined(__AVX2__)
+  for(; x + 8 <= length; x += 8) {
+    _mm256_storeu_si256((__m256i*)(target + x), gather(palette, source + x));
+  }
+  #endif
+  //without a gather instruction, the lookups are scalar; unrolling still lets them overlap.
+  for(; x + 4 <= length; x += 4) {
+    u32 c0 = palette[source[x + 0]];
+    u32 c1 = palette[source[x + 1]];
+    u32 c2 = palette[source[x + 2]];
+    u32 c3 = palette[source[x + 3]];
+    target[x + 0] = c0;
+    target[x + 1] = c1;
+    target[x + 2] = c2;
+    target[x + 3] = c3;
+  }
+  for(; x < length; x++) target[x] = palette[source[x]];
+}
+
+//target[x] = average(previous[x], palette[source[x]]); target may be previous.
+inline auto blend(u32* target, const u32* previous, const u32* source, const u32* palette, u32 length) -> void {
+  u32 x = 0;
+  #if defined(__AVX2__)
+  for(; x + 8 <= length; x += 8) {
+    auto a = _mm256_loadu_si256((const __m256i*)(previous + x));
+    _mm256_storeu_si256((__m256i*)(target + x), average(a, gather(palette, source + x)));
+  }
+  #elif defined(ARES_VIDEO_SSE2)
+  for(; x + 4 <= length; x += 4) {
+    auto a = _mm_loadu_si128((const __m128i*)(previous + x));
+    auto b = _mm_set_epi32(palette[source[x + 3]], palette[source[x + 2]], palette[source[x + 1]], palette[source[x + 0]]);
+    _mm_storeu_si128((__m128i*)(target + x), average(a, b));
+  }
+  #endif
+  for(; x < length; x++) target[x] = average(previous[x], palette[source[x]]);
+}
+
+//target[x] = average(source[x], source[x + distance]), or average(source[x], source[x]) where x + distance is past length.
+//only the first count pixels are written. target may be source: each group of pixels is read before it is written.
+inline auto bleed(u32* target, const u32* source, u32 length, u32 distance, u32 count) -> void {
+  u32 x = 0, blended = min(count, length - min(length, distance));
+  #if defined(__AVX2__)
+  for(; x + 8 <= blended; x += 8) {
+    auto a = _mm256_loadu_si256((const __m256i*)(source + x));
+    auto b = _mm256_loadu_si256((const __m256i*)(source + x + distance));
+    _mm256_storeu_si256((__m256i*)(target + x), average(a, b));
+  }
+  #endif
+  #if defined(ARES_VIDEO_SSE2)
+  for(; x + 4 <= blended; x += 4) {
+    auto a = _mm_loadu_si128((const __m128i*)(source + x));
+    auto b = _mm_loadu_si128((const __m128i*)(source + x + distance));
+    _mm_storeu_si128((__m128i*)(target + x), average(a, b));
+  }
+  #endif
+  for(; x < blended; x++) target[x] = average(source[x], source[x + distance]);
+  for(; x < count; x++) target[x] = average(source[x], source[x]);
+}
+
+inline auto bleed(u32* target, const u32* source, u32 length, u32 distance) -> void {
+  bleed(target, source, length, distance, length);
+}
+
+//the rotations read a width x height image and write the rotated image; pitches are in pixels.
+
+//rotates by 90 degrees counter-clockwise, into a height x width image.
+inline auto rotateLeft(u32* target, u32 targetPitch, const u32* source, u32 sourcePitch, u32 width, u32 height) -> void {
+  u32 y = 0;
+  #if defined(ARES_VIDEO_SSE2)
+  for(; y + 4 <= height; y += 4) {
+    u32 x = 0;
+    for(; x + 4 <= width; x += 4) {
+      auto r0 = _mm_loadu_si128((const __m128i*)(source + (y + 0) * sourcePitch + x));
+      auto r1 = _mm_loadu_si128((const __m128i*)(source + (y + 1) * sourcePitch + x));
+      auto r2 = _mm_loadu_si128((const __m128i*)(source + (y + 2) * sourcePitch + x));
+      auto r3 = _mm_loadu_si128((const __m128i*)(source + (y + 3) * sourcePitch + x));
+      transpose(r0, r1, r2, r3);
+      _mm_storeu_si128((__m128i*)(target + (width - 1 - x - 0) * targetPitch + y), r0);
+      _mm_storeu_si128((__m128i*)(target + (width - 1 - x - 1) * targetPitch + y), r1);
+      _mm_storeu_si128((__m128i*)(target + (width - 1 - x - 2) * targetPitch + y), r2);
+      _mm_storeu_si128((__m128i*)(target + (width - 1 - x - 3) * targetPitch + y), r3);
+    }
+    for(u32 row = y; row < y + 4; row++) {
+      for(u32 column = x; column < width; column++) {
+        target[(width - 1 - column) * targetPitch + row] = source[row * sourcePitch + column];
+      }
+    }
+  }
+  #endif
+  for(; y < height; y++) {
+    for(u32 x : range(width)) target[(width - 1 - x) * targetPitch + y] = source[y * sourcePitch + x];
+  }
+}
+
+//rotates by 180 degrees, into a width x height image.
+inline auto rotateHalf(u32* target, u32 targetPitch, const u32* source, u32 sourcePitch, u32 width, u32 height) -> void {
+  for(u32 y : range(height)) {
+    auto input = source + y * sourcePitch;
+    auto output = target + (height - 1 - y) * targetPitch + width;  //one past the end; filled backward
+    u32 x = 0;
+    #if defined(ARES_VIDEO_SSE2)
+    for(; x + 4 <= width; x += 4) {
+      _mm_storeu_si128((__m128i*)(output - x - 4), reverse(_mm_loadu_si128((const __m128i*)(input + x))));
+    }
+    #endif
+    for(; x < width; x++) output[-1 - (s32)x] = input[x];
+  }
+}
+
+//rotates by 90 degrees clockwise, into a height x width image.
+inline auto rotateRight(u32* target, u32 targetPitch, const u32* source, u32 sourcePitch, u32 width, u32 height) -> void {
+  u32 y = 0;
+  #if defined(ARES_VIDEO_SSE2)
+  for(; y + 4 <= height; y += 4) {
+    u32 x = 0;
+    for(; x + 4 <= width; x += 4) {
+      auto r0 = _mm_loadu_si128((const __m128i*)(source + (y + 0) * sourcePitch + x));
+      auto r1 = _mm_loadu_si128((const __m128i*)(source + (y + 1) * sourcePitch + x));
+      auto r2 = _mm_loadu_si128((const __m128i*)(source + (y + 2) * sourcePitch + x));
+      auto r3 = _mm_loadu_si128((const __m128i*)(source + (y + 3) * sourcePitch + x));
+      transpose(r0, r1, r2, r3);
+      //columns land in reverse row order: source row y + 3 is the leftmost pixel.
+      _mm_storeu_si128((__m128i*)(target + (x + 0) * targetPitch + (height - 4 - y)), reverse(r0));
+      _mm_storeu_si128((__m128i*)(target + (x + 1) * targetPitch + (height - 4 - y)), reverse(r1));
+      _mm_storeu_si128((__m128i*)(target + (x + 2) * targetPitch + (height - 4 - y)), reverse(r2));
+      _mm_storeu_si128((__m128i*)(target + (x + 3) * targetPitch + (height - 4 - y)), reverse(r3));
+    }
+    for(u32 row = y; row < y + 4; row++) {
+      for(u32 column = x; column < width; column++) {
+        target[column * targetPitch + (height - 1 - row)] = source[row * sourcePitch + column];
+      }
+    }
+  }
+  #endif
+  for(; y < height; y++) {
+    for(u32 x : range(width)) target[x * targetPitch + (height - 1 - y)] = source[y * sourcePitch + x];
+  }
+}
+
+}
@@ -7,6 +7,7 @@ Screen::Screen(string name, u32 width, u32 height) : Video(name) {
     _inputB = new u32[width * height]();
     _output = new u32[width * height]();
     _rotate = new u32[width * height]();
+    _line   = new u32[width]();
 
     if constexpr(ares::Video::Threaded) {
       _thread = nall::thread::create({&Screen::main, this});
@@ -31,6 +32,7 @@ auto Screen::main(uintptr_t) -> void {
     if(_frameCondition.wait_for(lock, timeout, [&] { return _frame.load(); })) {
       refresh();
       _frame = false;
+      _frameCondition.notify_all();  //wake frame() if it is waiting on this one
     }
 
     if(_kill) break;
@@ -39,6 +41,7 @@ auto Screen::main(uintptr_t) -> void {
 
 auto Screen::quit() -> void {
   _kill = true;
+  _frameCondition.notify_all();
   _thread.join();
   _sprites.reset();
 }
@@ -49,6 +52,7 @@ auto Screen::power() -> void {
   memory::fill<u32>(_inputB.data(), _canvasWidth * _canvasHeight, _fillColor);
   memory::fill<u32>(_output.data(), _canvasWidth * _canvasHeight, _fillColor);
   memory::fill<u32>(_rotate.data(), _canvasWidth * _canvasHeight, _fillColor);
+  _stale = false;
 }
 
 auto Screen::pixels(bool frame) -> array_span<u32> {
@@ -190,7 +194,11 @@ auto Screen::colors(u32 colors, function<n64 (n32)> color) -> void {
 
 auto Screen::frame() -> void {
   if(runAhead()) return;
-  while(_frame) spinloop();
+  if(_frame) {
+    //the previous frame is still being presented: sleep until it is done rather than spinning.
+    unique_lock<mutex> lock(_frameMutex);
+    _frameCondition.wait(lock, [&] { return !_frame || _kill; });
+  }
 
   lock_guard<recursive_mutex> lock(_mutex);
   _inputA.swap(_inputB);
@@ -199,7 +207,7 @@ auto Screen::frame() -> void {
     _frame = false;
   } else {
     _frame = true;
-    _frameCondition.notify_one();
+    _frameCondition.notify_all();
   }
 }
 
@@ -220,54 +228,74 @@ auto Screen::refresh() -> void {
   auto height = _canvasHeight;
   auto input  = _inputB.data();
   auto output = _output.data();
+  auto palette = _palette.data();
+
+  u32 bleed = _colorBleed ? _colorBleedWidth : 0;
+  bool doubled = _progressive && _progressiveDouble;
+  bool blend = _interframeBlending && !_interlace && !doubled;
+  bool rotate = _rotation == 90 || _rotation == 180 || _rotation == 270;
+  bool sprites = false;
+  for(auto& sprite : _sprites) sprites |= sprite->visible();
+
+  //when the frontend lends a buffer, the last pass renders the viewport straight into it, saving a copy.
+  //without rotation, that pass is the palette conversion, which cannot skip the output buffer
+  //when the next frame reads it back (blending, interlacing) or sprites are drawn over it.
+  u32 presentWidth  = _rotation == 90 || _rotation == 270 ? viewHeight : viewWidth;
+  u32 presentHeight = _rotation == 90 || _rotation == 270 ? viewWidth : viewHeight;
+  u32 rotatedWidth  = _rotation == 90 || _rotation == 270 ? height : width;
+  u32 rotatedHeight = _rotation == 90 || _rotation == 270 ? width : height;
+  VideoBuffer buffer;
+  if((rotate || (!blend && !_interlace && !sprites))
+  && viewX + presentWidth <= rotatedWidth && viewY + presentHeight <= rotatedHeight) {
+    buffer = platform->videoBuffer(shared(), presentWidth, presentHeight);
+  }
+
+  if(buffer && !rotate) {
+    for(u32 y : range(viewHeight)) {
+      auto source = input + (doubled ? (viewY + y) & ~1 : viewY + y) * pitch;
+      auto target = (u32*)((u8*)buffer.data + y * buffer.pitch);
+      if(bleed) {
+        Kernel::convert(_line.data(), source, palette, width);
+        Kernel::bleed(target, _line.data() + viewX, width - viewX, bleed, viewWidth);
+      } else {
+        Kernel::convert(target, source + viewX, palette, viewWidth);
+      }
+    }
+    _stale = true;
+    platform->video(shared(), buffer.data, buffer.pitch, viewWidth, viewHeight);
+    memory::fill<u32>(_inputB.data(), width * height, _fillColor);
+    return;
+  }
 
+  //palette conversion, interframe blending and color bleed are fused into one pass over each line,
+  //so that every line of the output is written once.
   for(u32 y : range(height)) {
     auto source = input  + y * pitch;
     auto target = output + y * width;
 
     if(_interlace) {
-      if((_interlaceField & 1) == (y & 1)) {
-        for(u32 x : range(width)) {
-          auto color = _palette[*source++];
-          *target++ = color;
+      if((_interlaceField & 1) != (y & 1)) {
+        if(!_stale) {
+          //the other field is kept from the previous frame.
+          if(bleed) Kernel::bleed(target, target, width, bleed);
+          continue;
         }
+        //the previous frame went straight to the frontend: repeat a line of this field instead.
+        source = input + ((y ^ 1) < height ? y ^ 1 : y) * pitch;
       }
-    } else if(_progressive && _progressiveDouble) {
+    } else if(doubled) {
       source = input + (y & ~1) * pitch;
-      for(u32 x : range(width)) {
-        auto color = _palette[*source++];
-        *target++ = color;
-      }
-    } else if(_interframeBlending) {
-      n32 mask = 1 << 24 | 1 << 16 | 1 << 8 | 1 << 0;
-      for(u32 x : range(width)) {
-        auto a = *target;
-        auto b = _palette[*source++];
-        *target++ = (a + b - ((a ^ b) & mask)) >> 1;
-      }
-    } else {
-      for(u32 x : range(width)) {
-        auto color = _palette[*source++];
-        *target++ = color;
-      }
     }
-  }
 
-  if (_colorBleed) {
-    n32 mask = 1 << 24 | 1 << 16 | 1 << 8 | 1 << 0;
-    for (u32 y : range(height)) {
-      auto target = output + y * width;
-      for (u32 x : range(0, width, _colorBleedWidth)) {
-        for (u32 offset = 0; offset < _colorBleedWidth && (x + offset) < width; ++offset) {
-          u32 next = x + _colorBleedWidth;
-          if (next + offset >= width) next = x;
-          auto a = target[x + offset];
-          auto b = target[next + offset];
-          target[x + offset] = (a + b - ((a ^ b) & mask)) >> 1;
-        }
-      }
+    auto line = bleed ? _line.data() : target;
+    if(blend && !_stale) {
+      Kernel::blend(line, target, source, palette, width);
+    } else {
+      Kernel::convert(line, source, palette, width);
     }
+    if(bleed) Kernel::bleed(target, line, width, bleed);
   }
+  _stale = false;
 
   for(auto& sprite : _sprites) {
     if(!sprite->visible()) continue;
@@ -289,41 +317,36 @@ auto Screen::refresh() -> void {
     }
   }
 
+  if(buffer) {
+    //only the part of the image that lands in the viewport is rotated, straight into the lent buffer.
+    //the source rectangle is the viewport rotated back: w x h pixels at (x, y).
+    u32 x = 0, y = 0, w = viewWidth, h = viewHeight;
+    if(_rotation ==  90) x = width - viewY - w, y = viewX;
+    if(_rotation == 180) x = width - viewX - w, y = height - viewY - h;
+    if(_rotation == 270) x = viewY, y = height - viewX - h;
+    auto source = output + y * width + x;
+    if(_rotation ==  90) Kernel::rotateLeft (buffer.data, buffer.pitch >> 2, source, width, w, h);
+    if(_rotation == 180) Kernel::rotateHalf (buffer.data, buffer.pitch >> 2, source, width, w, h);
+    if(_rotation == 270) Kernel::rotateRight(buffer.data, buffer.pitch >> 2, source, width, w, h);
+    platform->video(shared(), buffer.data, buffer.pitch, presentWidth, presentHeight);
+    memory::fill<u32>(_inputB.data(), width * height, _fillColor);
+    return;
+  }
+
   if(_rotation == 90) {
-    //rotate left
-    for(u32 y : range(height)) {
-      auto source = output + y * width;
-      for(u32 x : range(width)) {
-        auto target = _rotate.data() + (width - 1 - x) * height + y;
-        *target = *source++;
-      }
-    }
+    Kernel::rotateLeft(_rotate.data(), height, output, width, width, height);
     output = _rotate.data();
     swap(width, height);
     swap(viewWidth, viewHeight);
   }
 
   if(_rotation == 180) {
-    //rotate upside down
-    for(u32 y : range(height)) {
-      auto source = output + y * width;
-      for(u32 x : range(width)) {
-        auto target = _rotate.data() + (height - 1 - y) * width + (width - 1 - x);
-        *target = *source++;
-      }
-    }
+    Kernel::rotateHalf(_rotate.data(), width, output, width, width, height);
     output = _rotate.data();
   }
 
   if(_rotation == 270) {
-    //rotate right
-    for(u32 y : range(height)) {
-      auto source = output + y * width;
-      for(u32 x : range(width)) {
-        auto target = _rotate.data() + x * height + (height - 1 - y);
-        *target = *source++;
-      }
-    }
+    Kernel::rotateRight(_rotate.data(), height, output, width, width, height);
     output = _rotate.data();
     swap(width, height);
     swap(viewWidth, viewHeight);
@@ -93,6 +93,7 @@ protected:
   unique_pointer<u32[]> _inputB;
   unique_pointer<u32[]> _output;
   unique_pointer<u32[]> _rotate;
+  unique_pointer<u32[]> _line;
   unique_pointer<u32[]> _palette;
   vector<Node::Video::Sprite> _sprites;
 
@@ -108,6 +109,7 @@ protected:
   bool _progressiveDouble = false;
   bool _interlace = false;
   bool _interlaceField = false;
+  bool _stale = false;  //the last frame was rendered into a frontend buffer; _output does not hold it
   u32  _viewportX = 0;
   u32  _viewportY = 0;
   u32  _viewportWidth = 0;
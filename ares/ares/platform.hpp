@@ -10,6 +10,14 @@ enum class Event : u32 {
   Synchronize,
 };
 
+//a frontend-owned buffer that Screen may render a frame into directly; pitch is in bytes.
+struct VideoBuffer {
+  explicit operator bool() const { return data; }
+
+  u32* data = nullptr;
+  u32 pitch = 0;
+};
+
 struct Platform {
   virtual auto attach(Node::Object) -> void {}
   virtual auto detach(Node::Object) -> void {}
@@ -18,6 +26,8 @@ struct Platform {
   virtual auto log(Node::Debugger::Tracer::Tracer, string_view message) -> void {}
   virtual auto status(string_view message) -> void {}
   virtual auto video(Node::Video::Screen, const u32* data, u32 pitch, u32 width, u32 height) -> void {}
+  //lends a width x height buffer for the next frame; when one is returned, the following video() call points into it.
+  virtual auto videoBuffer(Node::Video::Screen, u32 width, u32 height) -> VideoBuffer { return {}; }
   virtual auto refreshRateHint(double refreshRate) -> void {}
   virtual auto audio(Node::Audio::Stream) -> void {}
   virtual auto midi(Node::Audio::MIDI) -> void {}
@@ -1,5 +1,6 @@
 inline auto Scheduler::reset() -> void {
   _threads.reset();
+  invalidate();
 }
 
 inline auto Scheduler::threads() const -> u32 {
@@ -45,11 +46,13 @@ inline auto Scheduler::append(Thread& thread) -> bool {
   thread._uniqueID = uniqueID();
   thread._clock = maximum() + thread._uniqueID;
   _threads.append(&thread);
+  invalidate();
   return true;
 }
 
 inline auto Scheduler::remove(Thread& thread) -> void {
   _threads.removeByValue(&thread);
+  invalidate();
 }
 
 //power cycle and soft reset events: assigns the primary thread and resets all thread clocks.
@@ -57,7 +60,9 @@ inline auto Scheduler::power(Thread& thread) -> void {
   _primary = _resume = thread.handle();
   for(auto& thread : _threads) {
     thread->_clock = thread->_uniqueID;
+    thread->_deadline = 0;
   }
+  invalidate();
 }
 
 inline auto Scheduler::enter(Mode mode) -> Event {
@@ -103,7 +108,10 @@ inline auto Scheduler::exit(Event event) -> void {
   auto reduce = minimum();
   for(auto& thread : _threads) {
     thread->_clock -= reduce;
+    thread->_deadline -= min(thread->_deadline, reduce);
   }
+  invalidate();
+  for(auto& thread : _threads) thread->rebase(reduce);
 
   //return to the thread that entered the scheduler originally.
   _event = event;
@@ -135,3 +143,41 @@ inline auto Scheduler::getSynchronize() -> bool {
 inline auto Scheduler::setSynchronize(bool synchronize) -> void {
   _synchronize = synchronize;
 }
+
+inline auto Scheduler::caching() const -> bool {
+  return _caching;
+}
+
+//when caching, Thread::synchronize() remembers the horizon it found and returns immediately until the caller reaches it,
+//rather than checking every thread on every call.
+inline auto Scheduler::setCaching(bool caching) -> void {
+  _caching = caching;
+  invalidate();
+}
+
+inline auto Scheduler::lazy() const -> bool {
+  return _lazy;
+}
+
+//when not lazy, deadlines are ignored, and every thread is kept in step with the others as if it had none.
+//this is only useful to check that a lazy thread behaves exactly as it would otherwise.
+inline auto Scheduler::setLazy(bool lazy) -> void {
+  _lazy = lazy;
+  for(auto& thread : _threads) thread->_deadline = 0;
+  invalidate();
+}
+
+//the other threads' clocks only advance while the owner is not running, which moves the true horizon later;
+//anything else that could move it earlier (clock changes, lowered deadlines, thread list changes) calls invalidate().
+inline auto Scheduler::horizon(Thread& owner) -> void {
+  _owner = &owner;
+  _horizon = (u64)-1;
+  for(auto& thread : _threads) {
+    if(thread == &owner || !thread->_handle) continue;
+    _horizon = min(_horizon, max(thread->_clock + 1, thread->_deadline));
+  }
+}
+
+inline auto Scheduler::invalidate() -> void {
+  _owner = nullptr;
+}
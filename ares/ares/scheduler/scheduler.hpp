@@ -32,7 +32,16 @@ struct Scheduler {
   auto getSynchronize() -> bool;
   auto setSynchronize(bool) -> void;
 
+  auto caching() const -> bool;
+  auto setCaching(bool) -> void;
+
+  auto lazy() const -> bool;
+  auto setLazy(bool) -> void;
+
 private:
+  auto horizon(Thread& owner) -> void;
+  auto invalidate() -> void;
+
   cothread_t _host = nullptr;     //program thread (used to exit scheduler)
   cothread_t _resume = nullptr;   //resume thread (used to enter scheduler)
   cothread_t _primary = nullptr;  //primary thread (used to synchronize components)
@@ -40,6 +49,10 @@ private:
   Event _event = Event::Step;
   vector<Thread*> _threads;
   bool _synchronize = false;
+  bool _caching = true;
+  bool _lazy = true;
+  Thread* _owner = nullptr;  //thread that _horizon was computed for
+  u64 _horizon = 0;          //earliest clock at which _owner could need to switch to another thread
 
   friend struct Thread;
 };
@@ -27,6 +27,7 @@ inline auto Thread::handle() const -> cothread_t { return _handle; }
 inline auto Thread::frequency() const -> u64 { return _frequency; }
 inline auto Thread::scalar() const -> u64 { return _scalar; }
 inline auto Thread::clock() const -> u64 { return _clock; }
+inline auto Thread::deadline() const -> u64 { return _deadline; }
 
 inline auto Thread::setHandle(cothread_t handle) -> void {
   _handle = handle;
@@ -43,6 +44,17 @@ inline auto Thread::setScalar(u64 scalar) -> void {
 
 inline auto Thread::setClock(u64 clock) -> void {
   _clock = clock;
+  scheduler.invalidate();
+}
+
+//a thread whose effects on other threads are confined to known times may run lazily:
+//Thread::synchronize() leaves it behind until the caller's clock reaches its deadline,
+//which it must keep no later than the next time it could raise an interrupt or otherwise affect another thread.
+//anything that reads or modifies its state in the meantime must call catchUp() first.
+inline auto Thread::setDeadline(u64 deadline) -> void {
+  if(!scheduler._lazy) deadline = 0;
+  if(deadline < _deadline) scheduler.invalidate();
+  _deadline = deadline;
 }
 
 inline auto Thread::create(double frequency, function<void ()> entryPoint) -> void {
@@ -54,6 +66,7 @@ inline auto Thread::create(double frequency, function<void ()> entryPoint) -> vo
   EntryPoints().append({_handle, entryPoint});
   setFrequency(frequency);
   setClock(0);
+  setDeadline(0);
   scheduler.append(*this);
 }
 
@@ -77,7 +90,12 @@ inline auto Thread::step(u32 clocks) -> void {
 inline auto Thread::synchronize() -> void {
   //note: this will call Thread::synchronize(*this) at some point, but this is safe:
   //the comparison will always fail as the current thread can never be behind itself.
-  for(auto thread : scheduler._threads) synchronize(*thread);
+  if(scheduler._owner == this && clock() < scheduler._horizon) return;
+  for(auto thread : scheduler._threads) {
+    if(clock() < thread->_deadline) continue;
+    synchronize(*thread);
+  }
+  if(scheduler._caching) scheduler.horizon(*this);
 }
 
 //ensure the specified thread(s) are caught up the current thread before proceeding.
@@ -95,26 +113,39 @@ inline auto Thread::synchronize(Thread& thread, P&&... p) -> void {
   if constexpr(sizeof...(p) > 0) synchronize(std::forward<P>(p)...);
 }
 
+//runs a lazy thread until it has caught up to the active thread.
+inline auto Thread::catchUp() -> void {
+  for(auto thread : scheduler._threads) {
+    if(thread->active()) return thread->synchronize(*this);
+  }
+}
+
 inline auto Thread::serialize(serializer& s) -> void {
   s(_frequency);
   s(_scalar);
   s(_clock);
+  if(s.reading()) _deadline = 0, scheduler.invalidate();  //recomputed once the thread runs again
 
   if(!scheduler._synchronize) {
-    static u8 stack[Thread::Size];
+    //only the context saved at the base of the stack and the part of the stack in use are stored.
+    //the running thread's saved stack pointer is stale, so all of its stack is stored.
     bool resume = co_active() == _handle;
-
-    if(s.reading()) {
-      s(stack);
-      s(resume);
-      memory::copy(_handle, stack, Thread::Size);
-      if(resume) scheduler._resume = _handle;
+    u32 used = Size - Context;
+    auto top = (u8*)_handle + Size;
+    auto sp = (u8*)co_stack_pointer(_handle);
+    if(s.writing() && !resume && sp >= (u8*)_handle + Context && sp <= top) {
+      used = min(used, (u32)(top - sp + StackGranularity - 1) / StackGranularity * StackGranularity);
     }
 
-    if(s.writing()) {
-      memory::copy(stack, _handle, Thread::Size);
-      s(stack);
-      s(resume);
+    //a different length shifts everything after it, so s no longer holds what follows:
+    if(s.writing() && s.generation() && s.size() + sizeof(u32) <= s.capacity()) {
+      if(memory::readl<sizeof(u32)>(s.data() + s.size()) != used) s.setGeneration(0);
     }
+    s(used);
+    s(resume);
+    used = min(used, (u32)(Size - Context));
+    s(array_span<u8>{_handle, Context});
+    s(array_span<u8>{top - used, used});
+    if(s.reading() && resume) scheduler._resume = _handle;
   }
 }
@@ -1,8 +1,10 @@
 struct Scheduler;
 
 struct Thread {
-  enum : u64 { Second = (u64)-1 >> 1 };
+  enum : u64 { Second = Constants::Second };
   enum : u64 { Size = 16_KiB * sizeof(void*) };
+  enum : u64 { Context = 1_KiB };          //libco keeps a suspended thread's registers at the base of its stack
+  enum : u64 { StackGranularity = 1_KiB };  //serialized stack lengths are rounded up to this
 
   struct EntryPoint {
     cothread_t handle = nullptr;
@@ -23,11 +25,13 @@ struct Thread {
   auto frequency() const -> u64;
   auto scalar() const -> u64;
   auto clock() const -> u64;
+  auto deadline() const -> u64;
 
   auto setHandle(cothread_t handle) -> void;
   auto setFrequency(double frequency) -> void;
   auto setScalar(u64 scalar) -> void;
   auto setClock(u64 clock) -> void;
+  auto setDeadline(u64 deadline) -> void;
 
   auto create(double frequency, function<void ()> entryPoint) -> void;
   auto restart(function<void ()> entryPoint) -> void;
@@ -36,6 +40,11 @@ struct Thread {
   auto step(u32 clocks) -> void;
   auto synchronize() -> void;
   template<typename... P> auto synchronize(Thread&, P&&...) -> void;
+  auto catchUp() -> void;
+
+  //called by Scheduler::exit() after it subtracts reduce from every thread clock,
+  //for threads that keep clock values of their own (eg to timestamp output)
+  virtual auto rebase(u64 reduce) -> void {}
 
   auto serialize(serializer& s) -> void;
 
@@ -45,6 +54,7 @@ protected:
   u64 _frequency = 0;
   u64 _scalar = 0;
   u64 _clock = 0;
+  u64 _deadline = 0;
 
   friend struct Scheduler;
 };
@@ -45,39 +45,23 @@ auto APU::load(Node::Object parent) -> void {
     }
   }
 
-  midi = node->append<Node::Audio::MIDI>("MIDI");
-  midiEmitter = MIDIEmitter([&](u8 cmd, u8 d1, u8 d2){
-    d1 &= 0x7F;
-    d2 &= 0x7F;
-
-    // prevent sending redundant updates:
-    if ((cmd & 0xF0) == 0xB0) {
-      if (chanCC[cmd & 0x0F][d1] == d2) {
-        return;
-      }
-
-      chanCC[cmd & 0x0F][d1] = d2;
-    } else if ((cmd & 0xF0) == 0xC0) {
-      if (chanProgram[cmd & 0x0F] == d1) {
-        return;
-      }
-
-      chanProgram[cmd & 0x0F] = d1;
-    }
-
-    midi->writeShort(cmd, d1, d2);
+  for(u32 period : range(2048)) {
+    f64 frequency = 1'789'773.0 / (16.0 * (period + 1.0));
+    // A0 = midi note 21; 27.5Hz
+    midiPeriodNote[period] = 12.0 * log2(frequency / 27.5) + 21.0;
+  }
 
-    midiMessages++;
-    bpsMidiMessages++;
-  });
+  midi = node->append<Node::Audio::MIDI>("MIDI");
+  midi->setFrequency(u32(system.frequency() + 0.5) / rate());
+  midi->setTracks({"APU", "Pulse 1", "Pulse 2", "Triangle", "Noise", "DMC"});
 
   midiInit();
 }
 
 auto APU::unload() -> void {
   midiReset();
+  midi->frame(clock());
 
-  midiEmitter.reset();
   node->remove(midi);
 
   node->remove(stream);
@@ -96,14 +80,15 @@ auto APU::main() -> void {
   output += pulseDAC[pulseOutput];
   output += dmcTriangleNoiseDAC[dmcOutput][triangleOutput][noiseOutput];
 
-  stream->frame(sclamp<16>(output) / 32768.0);
+  if(!runAhead()) {
+    samples[sampleCount++] = sclamp<16>(output) / 32768.0;
+    if(sampleCount == std::size(samples)) stream->write({samples, sampleCount}), sampleCount = 0;
+  }
 
-  generateMidi();
-  if (bpsCycles++ >= 1'789'773UL) {
-    // 30 bits per message (1 start bit, 8 data bit, 1 stop bit)
-    printf("midi: %5lu bps\n", bpsMidiMessages * 30UL);
-    bpsCycles = 0UL;
-    bpsMidiMessages = 0UL;
+  // translation is suspended during speculative (run-ahead) frames, which are always rolled back:
+  if (!midi->speculative()) {
+    if (midiCycle >= midiDue) generateMidi();
+    midiCycle++;
   }
 
   tick();
@@ -111,9 +96,36 @@ auto APU::main() -> void {
 
 auto APU::tick() -> void {
   Thread::step(rate());
+  //the CPU leaves the APU behind until it could next raise an IRQ or request a DMC DMA:
+  u32 cycles = eventCycles();
+  Thread::setDeadline(clock() + (u64)scalar() * rate() * (cycles - min(cycles, 2u)));
   Thread::synchronize(cpu);
 }
 
+//returns a lower bound on the number of cycles until the frame counter or DMC can next affect the CPU.
+//register writes and DMC DMA transfers change this, and so end the batch the APU is running in.
+auto APU::eventCycles() const -> u32 {
+  u32 cycles = frame.counter;
+  if(frame.delay) cycles = min(cycles, (u32)frame.delayCounter);
+  if(dmc.dmaDelayCounter) cycles = min(cycles, (u32)dmc.dmaDelayCounter);
+  if(dmc.lengthCounter) {
+    u32 period = Region::PAL() ? dmcPeriodTablePAL[dmc.period] : dmcPeriodTableNTSC[dmc.period];
+    cycles = min(cycles, dmc.periodCounter + (7 - dmc.bitCounter) * period);
+  }
+  return cycles;
+}
+
+//called by the PPU at the end of each video frame, immediately before Scheduler::exit().
+auto APU::midiFrame() -> void {
+  catchUp();
+  midi->frame(clock());
+}
+
+//keeps the MIDI node's clock in step with the thread clock, whichever Scheduler::exit() rebased it.
+auto APU::rebase(u64 reduce) -> void {
+  midi->rebase(reduce);
+}
+
 auto APU::setIRQ() -> void {
   cpu.apuLine(frame.irqPending | dmc.irqPending);
 }
@@ -128,12 +140,15 @@ auto APU::power(bool reset) -> void {
   dmc.power(reset);
   frame.power(reset);
 
+  sampleCount = 0;
+  midi->setClock(clock());
   midiInit();
 
   setIRQ();
 }
 
 auto APU::readIO(n16 address) -> n8 {
+  catchUp();
   n8 data = cpu.io.openBus;
 
   switch(address) {
@@ -158,6 +173,10 @@ auto APU::readIO(n16 address) -> n8 {
 }
 
 auto APU::writeIO(n16 address, n8 data) -> void {
+  catchUp();
+  setDeadline(0);
+  midiUpdate();
+
   switch(address) {
 
   case 0x4000: {
@@ -181,14 +200,14 @@ auto APU::writeIO(n16 address, n8 data) -> void {
   case 0x4002: {
     pulse1.period.bit(0,7) = data.bit(0,7);
     pulse1.sweep.pulsePeriod.bit(0,7) = data.bit(0,7);
-    pulse1.m.periodWriteCountdown = 256;
+    pulse1.m.periodWriteCycle = midiCycle + 256;
     return;
   }
 
   case 0x4003: {
     pulse1.period.bit(8,10) = data.bit(0,2);
     pulse1.sweep.pulsePeriod.bit(8,10) = data.bit(0,2);
-    pulse1.m.periodWriteCountdown = 256;
+    pulse1.m.periodWriteCycle = midiCycle + 256;
 
     pulse1.dutyCounter = 0;
     pulse1.envelope.reloadDecay = true;
@@ -218,14 +237,14 @@ auto APU::writeIO(n16 address, n8 data) -> void {
   case 0x4006: {
     pulse2.period.bit(0,7) = data.bit(0,7);
     pulse2.sweep.pulsePeriod.bit(0,7) = data.bit(0,7);
-    pulse2.m.periodWriteCountdown = 256;
+    pulse2.m.periodWriteCycle = midiCycle + 256;
     return;
   }
 
   case 0x4007: {
     pulse2.period.bit(8,10) = data.bit(0,2);
     pulse2.sweep.pulsePeriod.bit(8,10) = data.bit(0,2);
-    pulse2.m.periodWriteCountdown = 256;
+    pulse2.m.periodWriteCycle = midiCycle + 256;
 
     pulse2.dutyCounter = 0;
     pulse2.envelope.reloadDecay = true;
@@ -242,13 +261,13 @@ auto APU::writeIO(n16 address, n8 data) -> void {
 
   case 0x400a: {
     triangle.period.bit(0,7) = data.bit(0,7);
-    triangle.m.periodWriteCountdown = 256;
+    triangle.m.periodWriteCycle = midiCycle + 256;
     return;
   }
 
   case 0x400b: {
     triangle.period.bit(8,10) = data.bit(0,2);
-    triangle.m.periodWriteCountdown = 256;
+    triangle.m.periodWriteCycle = midiCycle + 256;
 
     triangle.reloadLinear = true;
 
@@ -324,6 +343,7 @@ auto APU::writeIO(n16 address, n8 data) -> void {
 }
 
 auto APU::clockQuarterFrame() -> void {
+  midiUpdate();
   pulse1.envelope.clock();
   pulse2.envelope.clock();
   triangle.clockLinearLength();
@@ -331,6 +351,7 @@ auto APU::clockQuarterFrame() -> void {
 }
 
 auto APU::clockHalfFrame() -> void {
+  midiUpdate();
   pulse1.length.main();
   pulse1.sweep.clock(0);
   pulse2.length.main();
@@ -344,6 +365,8 @@ auto APU::clockHalfFrame() -> void {
   noise.envelope.clock();
 }
 
+f64 APU::midiPeriodNote[2048];
+
 const n16 APU::noisePeriodTableNTSC[16] = {
   4, 8, 16, 32, 64, 96, 128, 160, 202, 254, 380, 508, 762, 1016, 2034, 4068,
 };
@@ -362,39 +385,45 @@ const n16 APU::dmcPeriodTablePAL[16] = {
 
 auto APU::midiReset() -> void {
   // note off on all channels:
+  midiTrack = MIDITrack::Pulse1;
   if (pulse1.m.lastNoteOn) {
-    midiEmitter(0x80 | pulse1.m.chans[0], pulse1.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse1.m.chans[1], pulse1.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse1.m.chans[2], pulse1.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse1.m.chans[3], pulse1.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse1.m.chans[0], pulse1.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse1.m.chans[1], pulse1.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse1.m.chans[2], pulse1.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse1.m.chans[3], pulse1.m.lastNoteOn, 0x00);
   }
+  midiTrack = MIDITrack::Pulse2;
   if (pulse2.m.lastNoteOn) {
-    midiEmitter(0x80 | pulse2.m.chans[0], pulse2.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse2.m.chans[1], pulse2.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse2.m.chans[2], pulse2.m.lastNoteOn, 0x00);
-    midiEmitter(0x80 | pulse2.m.chans[3], pulse2.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse2.m.chans[0], pulse2.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse2.m.chans[1], pulse2.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse2.m.chans[2], pulse2.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | pulse2.m.chans[3], pulse2.m.lastNoteOn, 0x00);
   }
+  midiTrack = MIDITrack::Triangle;
   if (triangle.m.lastNoteOn) {
-    midiEmitter(0x80 | triangle.m.noteChan, triangle.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | triangle.m.noteChan, triangle.m.lastNoteOn, 0x00);
   }
+  midiTrack = MIDITrack::Noise;
   if (noise.m.lastNoteOn) {
-    midiEmitter(0x80 | noise.m.noteChan, noise.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | noise.m.noteChan, noise.m.lastNoteOn, 0x00);
   }
+  midiTrack = MIDITrack::DMC;
   if (dmc.m.lastNoteOn) {
-    midiEmitter(0x80 | dmc.m.lastChan, dmc.m.lastNoteOn, 0x00);
+    midiEmit(0x80 | dmc.m.lastChan, dmc.m.lastNoteOn, 0x00);
   }
 
   // all notes off:
+  midiTrack = MIDITrack::Global;
   for (int i = 0; i < 16; i++) {
     midi->delay();
-    midiEmitter(0xB0 | i, 123, 0x00);
+    midiEmit(0xB0 | i, 123, 0x00);
     midi->delay();
   }
 
   // reset all controllers:
   for (int i = 0; i < 16; i++) {
     midi->delay();
-    midiEmitter(0xB0 | i, 121, 0x00);
+    midiEmit(0xB0 | i, 121, 0x00);
     midi->delay();
     midi->delay();
     midi->delay();
@@ -404,8 +433,9 @@ auto APU::midiReset() -> void {
 }
 
 auto APU::midiInit() -> void {
-  midiClocks = 0;
   midiMessages = 0;
+  midiCycle = 0;
+  midiDue = 0;
 
   // reset MIDI:
   midiReset();
@@ -419,6 +449,7 @@ auto APU::midiInit() -> void {
 
   for (int c = 0; c < 16; c++) {
     chanProgram[c] = 255;
+    chanWheel[c] = 0xffff;
     for (int n = 0; n < 128; n++) {
       chanCC[c][n] = 255;
     }
@@ -434,6 +465,7 @@ auto APU::midiInit() -> void {
     pulse1.m.chans[n] = n;
     pulse2.m.chans[n] = n+4;
 
+    midiTrack = MIDITrack::Pulse1;
     midi->delay();
     midiProgram(pulse1.m.chans[n], dutyPCs[n]);
     midi->delay();
@@ -441,6 +473,7 @@ auto APU::midiInit() -> void {
     midi->delay();
     midiCC(pulse1.m.chans[n], 0x0A, 0x28); // pan
 
+    midiTrack = MIDITrack::Pulse2;
     midi->delay();
     midiProgram(pulse2.m.chans[n], dutyPCs[n]);
     midi->delay();
@@ -450,6 +483,7 @@ auto APU::midiInit() -> void {
   }
 
   triangle.m.chans[0] = 8;
+  midiTrack = MIDITrack::Triangle;
   midi->delay();
   midiProgram(triangle.m.chans[0], 33); // fingered bass
   midi->delay();
@@ -458,33 +492,38 @@ auto APU::midiInit() -> void {
   midiCC(triangle.m.chans[0], 0x0A, 0x40); // pan
 
   noise.m.chans[0] = 9;
+  midiTrack = MIDITrack::Noise;
   midi->delay();
   midiProgram(noise.m.chans[0], 0); // standard kit
   midi->delay();
   midiCC(noise.m.chans[0], 0x07, 0x60); // vol
 
 #if 0
+  midiTrack = MIDITrack::DMC;
   // DMC orchestra hit
   midi->delay();
-  midiEmitter(0xC0 | 10, 55, 0); // orchestra hit
+  midiEmit(0xC0 | 10, 55, 0); // orchestra hit
   midi->delay();
-  midiEmitter(0xB0 | 10, 0x07, 0x60); // vol
+  midiEmit(0xB0 | 10, 0x07, 0x60); // vol
 
   // DMC slap bass
   midi->delay();
-  midiEmitter(0xC0 | 11, 37, 0); // slap bass 2
+  midiEmit(0xC0 | 11, 37, 0); // slap bass 2
   midi->delay();
-  midiEmitter(0xB0 | 11, 0x07, 0x60); // vol
+  midiEmit(0xB0 | 11, 0x07, 0x60); // vol
 #endif
 
+  midiTrack = MIDITrack::Global;
   midiMessages = 0;
 }
 
 auto APU::MidiState::rateLimit() -> bool {
-  // MIDI message takes 0.000960000 sec (= 3 bytes / 3,125 bytes / sec)
-  //    APU cycle takes 0.000000560 sec
-  // means we can send one MIDI message every 1714.28571429 APU clock cycles:
-  if (clocks++ < 1715*messages) {
+  // the MIDI node paces all voices against the shared link itself:
+  if (apu.midi->scheduler()) return false;
+
+  if (apu.midiCycle < limitCycle) {
+    apu.midi->telemetry().stalls++;
+    apu.midiWake(limitCycle);
     return true;
   }
 
@@ -494,10 +533,10 @@ auto APU::MidiState::rateLimit() -> bool {
 }
 
 auto APU::MidiState::rateControl() -> void {
-  // record how many MIDI messages were emitted:
-  messages = apu.midiMessages;
-  // start counting APU clock cycles until we can generate more MIDI messages:
-  clocks = 0;
+  // MIDI message takes 0.000960000 sec (= 3 bytes / 3,125 bytes / sec)
+  //    APU cycle takes 0.000000560 sec
+  // means we can send one MIDI message every 1714.28571429 APU clock cycles:
+  limitCycle = apu.midiCycle + 1715 * apu.midiMessages;
 }
 
 auto APU::MidiState::applyNoteWheel(double n) -> void {
@@ -534,15 +573,112 @@ auto APU::MidiState::applyNoteWheel(double n) -> void {
   noteFreq = n;
 }
 
+auto APU::midiEmit(u8 cmd, u8 d1, u8 d2) -> void {
+  d1 &= 0x7F;
+  d2 &= 0x7F;
+
+  // prevent sending redundant updates:
+  if ((cmd & 0xF0) == 0xB0) {
+    if (chanCC[cmd & 0x0F][d1] == d2) {
+      midi->telemetry().dropped++;
+      return;
+    }
+
+    chanCC[cmd & 0x0F][d1] = d2;
+  } else if ((cmd & 0xF0) == 0xC0) {
+    if (chanProgram[cmd & 0x0F] == d1) {
+      midi->telemetry().dropped++;
+      return;
+    }
+
+    chanProgram[cmd & 0x0F] = d1;
+  } else if ((cmd & 0xF0) == 0xE0) {
+    chanWheel[cmd & 0x0F] = d2 << 7 | d1;
+  }
+
+  midi->write(clock(), cmd, d1, d2, midiTrack);
+
+  midiMessages++;
+}
+
+auto APU::midiDevice() -> MIDIDevice {
+  MIDIDevice device;
+  auto voices = midiVoices();
+  for (u32 n : range(5)) {
+    device.notes[n] = {voices[n]->lastChan, voices[n]->lastNoteOn};
+  }
+  memory::copy(device.program, chanProgram, sizeof(chanProgram));
+  memory::copy(device.cc, chanCC, sizeof(chanCC));
+  memory::copy(device.wheel, chanWheel, sizeof(chanWheel));
+  return device;
+}
+
+//after a state load, moves the device from the state it is actually in to the one the translator was restored to,
+//sending only the messages that differ. a restored note that the device is not sounding is forgotten instead of
+//started here, so that the voice starts it again (with its current pitch and volume) only if it is still wanted.
+auto APU::midiReconcile(const MIDIDevice& device) -> void {
+  auto voices = midiVoices();
+  auto sounding = [&](u8 chan, u8 note) -> bool {
+    for (auto voice : voices) {
+      if (voice->lastNoteOn == note && voice->lastChan == chan) return true;
+    }
+    return false;
+  };
+
+  // stop notes the restored state is not playing:
+  for (u32 n : range(5)) {
+    auto& note = device.notes[n];
+    if (note.note == 0 || sounding(note.chan, note.note)) continue;
+    midiTrack = MIDITrack::Pulse1 + n;
+    midiEmit(0x80 | note.chan, note.note, 0x00);
+  }
+
+  for (u32 n : range(5)) {
+    auto& m = *voices[n];
+    if (m.lastNoteOn == 0) continue;
+    bool playing = false;
+    for (auto& note : device.notes) {
+      if (note.note == m.lastNoteOn && note.chan == m.lastChan) playing = true;
+    }
+    if (playing) continue;
+    m.lastNoteOn = 0;
+    m.lastVel = 0;
+    m.lastFreq = 0;
+  }
+
+  // restore channel state; values the restored state never sent are left as the device has them:
+  midiTrack = MIDITrack::Global;
+  for (u32 c : range(16)) {
+    u8 program = chanProgram[c];
+    chanProgram[c] = device.program[c];
+    if (program != 255 && program != device.program[c]) midiProgram(c, program);
+
+    for (u32 n : range(128)) {
+      u8 value = chanCC[c][n];
+      chanCC[c][n] = device.cc[c][n];
+      if (value != 255 && value != device.cc[c][n]) midiCC(c, n, value);
+    }
+
+    u16 wheel = chanWheel[c];
+    chanWheel[c] = device.wheel[c];
+    if (wheel != 0xffff && wheel != device.wheel[c]) midiEmit(0xE0 | c, wheel & 0x7F, wheel >> 7 & 0x7F);
+  }
+}
+
 auto APU::midiProgram(u8 chan, u8 program) -> void {
-  midiEmitter(0xC0 | (chan & 0x0F), program & 0x7F, 0);
+  midiEmit(0xC0 | (chan & 0x0F), program & 0x7F, 0);
 }
 
 auto APU::midiCC(u8 chan, u8 controller, u8 value) -> void {
-  midiEmitter(0xB0 | (chan & 0x0F), controller & 0x7F, value & 0x7F);
+  midiEmit(0xB0 | (chan & 0x0F), controller & 0x7F, value & 0x7F);
 }
 
+//MIDI state is derived only when it may have changed: after a register write, a frame counter clock, or a
+//DMC sample ending. voices that are waiting on a timer (rate limiting, delayed period sampling) request
+//another pass at the cycle the timer expires through midiWake().
 auto APU::generateMidi() -> void {
+  midiDue = ~0ull;
+
   // always update latest desired midi state:
   pulse1.calculateMidi();
   pulse2.calculateMidi();
@@ -551,11 +687,17 @@ auto APU::generateMidi() -> void {
   dmc.calculateMidi();
 
   // emit messages to transition to desired midi state:
-  dmc.generateMidi( midiEmitter );
-  noise.generateMidi( midiEmitter );
-  triangle.generateMidi( midiEmitter );
-  pulse1.generateMidi( midiEmitter );
-  pulse2.generateMidi( midiEmitter );
+  midiTrack = MIDITrack::DMC;
+  dmc.generateMidi();
+  midiTrack = MIDITrack::Noise;
+  noise.generateMidi();
+  midiTrack = MIDITrack::Triangle;
+  triangle.generateMidi();
+  midiTrack = MIDITrack::Pulse1;
+  pulse1.generateMidi();
+  midiTrack = MIDITrack::Pulse2;
+  pulse2.generateMidi();
+  midiTrack = MIDITrack::Global;
 }
 
 }
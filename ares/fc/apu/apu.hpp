@@ -1,6 +1,6 @@
-struct APU : Thread {
-  using MIDIEmitter = function<auto (u8 cmd, u8 data1, u8 data2) -> void>;
+#include "dmc-database.hpp"
 
+struct APU : Thread {
   Node::Object node;
   Node::Audio::Stream stream;
   Node::Audio::MIDI midi;
@@ -13,6 +13,7 @@ struct APU : Thread {
 
   auto main() -> void;
   auto tick() -> void;
+  auto eventCycles() const -> u32;
   auto setIRQ() -> void;
 
   auto power(bool reset) -> void;
@@ -31,7 +32,7 @@ struct APU : Thread {
     n14 noteWheel;
     double noteFreq;
     u2  noteDuty;
-    u32 clocksSinceNoteOn;
+    u64 noteOnCycle;
 
     u8 chanProgram;
     u8 chanVolume;
@@ -42,7 +43,7 @@ struct APU : Thread {
     n14 lastWheel;
     double lastFreq;
 
-    u32 periodWriteCountdown;
+    u64 periodWriteCycle;  //a period written across two registers is sampled only after this cycle
 
     u16 lastPeriod;
     u32 lastCycleVolume;
@@ -61,9 +62,11 @@ struct APU : Thread {
     auto rateControl() -> void;
     
     auto applyNoteWheel(double n) -> void;
+
+    //serialization.cpp
+    auto serialize(serializer&) -> void;
     
-    u32 messages;
-    u32 clocks;
+    u64 limitCycle;  //no further messages may be sent before this cycle
   };
 
   struct Length {
@@ -140,7 +143,7 @@ struct APU : Thread {
     auto serialize(serializer&) -> void;
 
     auto calculateMidi() -> void;
-    auto generateMidi(MIDIEmitter&) -> void;
+    auto generateMidi() -> void;
     MidiState m;
 
     Length length;
@@ -164,7 +167,7 @@ struct APU : Thread {
     auto serialize(serializer&) -> void;
 
     auto calculateMidi() -> void;
-    auto generateMidi(MIDIEmitter&) -> void;
+    auto generateMidi() -> void;
     MidiState m;
 
     Length length;
@@ -187,7 +190,7 @@ struct APU : Thread {
     auto serialize(serializer&) -> void;
 
     auto calculateMidi() -> void;
-    auto generateMidi(MIDIEmitter&) -> void;
+    auto generateMidi() -> void;
     MidiState m;
 
     Length length;
@@ -218,12 +221,19 @@ struct APU : Thread {
     auto serialize(serializer&) -> void;
 
     auto calculateMidi() -> void;
-    auto generateMidi(MIDIEmitter&) -> void;
+    auto generateMidi() -> void;
     MidiState m;
 
-    using generateMidiFromPeriod = function<auto (n4 p, u8& ch_o, u8& cp_o, u8& cv_o, double& n_o, u8& v_o) -> void>;
+    //dmc.cpp
+    static auto database() -> const DMCSampleDatabase&;
+    auto sampleHash() -> u64;
 
-    nall::map<u64, generateMidiFromPeriod> sampleDescriptors;
+    struct SampleHash {
+      u32 last;  //program ROM offset of the final sample byte
+      u64 hash;  //FNV-64a of the sample contents
+    };
+    nall::map<u64, SampleHash> sampleHashes;
+    u32 sampleHashesGeneration = 0;
     nall::map<u64, nall::map<n4, bool> > samplesMissing;
     u32 clocksSinceStart;
 
@@ -291,20 +301,46 @@ struct APU : Thread {
 
   FrameCounter frame;
 
-  MIDIEmitter midiEmitter;
+  //MIDI node tracks: the voice responsible for each emitted message
+  struct MIDITrack { enum : u8 { Global, Pulse1, Pulse2, Triangle, Noise, DMC }; };
+
+  u8 midiTrack = MIDITrack::Global;
   u32 midiMessages;
-  u32 midiClocks;
-  u32 bpsMidiMessages;
-  u32 bpsCycles;
+  u64 midiCycle;  //APU cycles since power
+  u64 midiDue;    //cycle at which MIDI state must next be derived
+  static f64 midiPeriodNote[2048];  //MIDI note number of each pulse channel period
   u8 chanProgram[16];
   u8 chanCC[16][128];
+  u16 chanWheel[16];  //last pitch bend sent on each channel (0xffff = unknown)
+
+  //the state of the MIDI device, as far as the messages sent to it determine:
+  struct MIDIDevice {
+    struct Note {
+      u8 chan;
+      u8 note;  //0 = none sounding
+    } notes[5];  //one per voice, in MIDITrack order
+    u8 program[16];
+    u8 cc[16][128];
+    u16 wheel[16];
+  };
+  auto midiVoices() -> array<MidiState*[5]> { return {&pulse1.m, &pulse2.m, &triangle.m, &noise.m, &dmc.m}; }
+  auto midiDevice() -> MIDIDevice;
+  auto midiReconcile(const MIDIDevice& device) -> void;
   auto midiInit() -> void;
   auto midiReset() -> void;
+  auto midiFrame() -> void;
+  auto rebase(u64 reduce) -> void override;
   auto generateMidi() -> void;
+  auto midiUpdate() -> void { midiDue = midiCycle; }
+  auto midiWake(u64 cycle) -> void { midiDue = min(midiDue, cycle); }
+  auto midiEmit(u8 cmd, u8 data1, u8 data2) -> void;
   auto midiProgram(u8 chan, u8 program) -> void;
   auto midiCC(u8 chan, u8 controller, u8 value) -> void;
 
 //unserialized:
+  f64 samples[64];  //output collected to be written to the stream as a block
+  u32 sampleCount = 0;
+
   u16 pulseDAC[32];
   u16 dmcTriangleNoiseDAC[128][16][16];
 
@@ -0,0 +1,107 @@
+//DMC sample database: maps the FNV-64a hash of a DMC sample to the MIDI note it is translated into.
+//dmc.bml is the editable source; dmc.db is its compiled form, a sorted array of fixed-size little-endian records
+//that is memory-mapped as-is and searched in place. run tools/dmc2db to rebuild dmc.db after editing dmc.bml.
+
+struct DMCSampleDatabase {
+  static constexpr u32 Signature = 0x42434d44;  //"DMCB"
+  static constexpr u32 Version = 1;
+
+  struct Header {
+    u32 signature;
+    u32 version;
+    u32 count;
+    u32 reserved;
+  };
+
+  struct Sample {
+    u64 hash;      //FNV-64a of the sample contents
+    u8  channel;
+    u8  program;
+    u8  volume;
+    u8  velocity;
+    u32 reserved;
+    f32 note[16];  //MIDI note for each DMC period; fractional notes are reached by pitch bend
+  };
+
+  static_assert(sizeof(Header) == 16);
+  static_assert(sizeof(Sample) == 80);
+
+  explicit operator bool() const { return _samples; }
+  auto size() const -> u32 { return _count; }
+
+  //maps a compiled database.
+  auto open(const string& filename) -> bool {
+    close();
+    if(!_map.open(filename, file_map::mode::read)) return false;
+    if(!attach(_map.data(), _map.size())) return close(), false;
+    return true;
+  }
+
+  //compiles dmc.bml markup and uses the result in place of a mapped file.
+  auto openMarkup(const string& markup) -> bool {
+    close();
+    _buffer = compile(markup);
+    if(!attach(_buffer.data(), _buffer.size())) return close(), false;
+    return true;
+  }
+
+  auto close() -> void {
+    _map.close();
+    _buffer.reset();
+    _samples = nullptr;
+    _count = 0;
+  }
+
+  auto find(u64 hash) const -> const Sample* {
+    u32 lo = 0, hi = _count;
+    while(lo < hi) {
+      u32 mid = lo + (hi - lo) / 2;
+      if(_samples[mid].hash < hash) lo = mid + 1;
+      else hi = mid;
+    }
+    if(lo < _count && _samples[lo].hash == hash) return &_samples[lo];
+    return nullptr;
+  }
+
+  //converts dmc.bml markup into a compiled database image.
+  static auto compile(const string& markup) -> vector<u8> {
+    vector<Sample> samples;
+    for(auto node : BML::unserialize(markup)) {
+      if(node.name() != "sample") continue;
+      Sample sample{};
+      sample.hash = node["fnv64a"].string().natural();
+      sample.channel = node["channel"].natural(9);
+      sample.program = node["program"].natural(0);
+      sample.volume = node["volume"].natural(0x60);
+      sample.velocity = node["velocity"].natural(96);
+      for(u32 period : range(16)) {
+        sample.note[period] = node[{"p", hex(period, 1L).upcase()}].real(0.0);
+      }
+      samples.append(sample);
+    }
+    samples.sort([](const Sample& lhs, const Sample& rhs) { return lhs.hash < rhs.hash; });
+
+    Header header{Signature, Version, (u32)samples.size(), 0};
+    vector<u8> image;
+    image.resize(sizeof(Header) + samples.size() * sizeof(Sample));
+    memory::copy(image.data(), &header, sizeof(Header));
+    memory::copy(image.data() + sizeof(Header), samples.data(), samples.size() * sizeof(Sample));
+    return image;
+  }
+
+private:
+  auto attach(const u8* data, u64 size) -> bool {
+    if(!data || size < sizeof(Header)) return false;
+    auto header = (const Header*)data;
+    if(header->signature != Signature || header->version != Version) return false;
+    if(size < sizeof(Header) + (u64)header->count * sizeof(Sample)) return false;
+    _samples = (const Sample*)(data + sizeof(Header));
+    _count = header->count;
+    return true;
+  }
+
+  file_map _map;
+  vector<u8> _buffer;
+  const Sample* _samples = nullptr;
+  u32 _count = 0;
+};
@@ -71,213 +71,34 @@ auto APU::DMC::power(bool reset) -> void {
   sampleValid = 0;
   sample = 0;
 
-  // map sample hashes to functions that return MIDI data:
-  sampleDescriptors.reset();
+  sampleHashes.reset();
   samplesMissing.reset();
+}
 
-  printf("loading `dmc.bml` from `%s`\n", Path::resources().data());
-  if(auto fp = file::open({Path::resources(), "dmc.bml"}, file::mode::read)) {
-    string markup;
-    markup.resize(fp.size());
-    fp.read(markup);
-    auto list = BML::unserialize(markup);
-    for (auto node : list) {
-      u64 h = node["fnv64a"].string().natural();
-
-      u8 ch = node["channel"].natural(9);
-      u8 cp = node["program"].natural(0);
-      u8 cv = node["volume"].natural(0x60);
-
-      u8 v =  node["velocity"].natural(96);
-
-      double n[16];
-      n[0x0] = node["p0"].real(0.0);
-      n[0x1] = node["p1"].real(0.0);
-      n[0x2] = node["p2"].real(0.0);
-      n[0x3] = node["p3"].real(0.0);
-      n[0x4] = node["p4"].real(0.0);
-      n[0x5] = node["p5"].real(0.0);
-      n[0x6] = node["p6"].real(0.0);
-      n[0x7] = node["p7"].real(0.0);
-      n[0x8] = node["p8"].real(0.0);
-      n[0x9] = node["p9"].real(0.0);
-      n[0xA] = node["pA"].real(0.0);
-      n[0xB] = node["pB"].real(0.0);
-      n[0xC] = node["pC"].real(0.0);
-      n[0xD] = node["pD"].real(0.0);
-      n[0xE] = node["pE"].real(0.0);
-      n[0xF] = node["pF"].real(0.0);
-
-      sampleDescriptors.insert(h, [=](n4 p, u8& ch_o, u8& cp_o, u8& cv_o, double& n_o, u8& v_o){
-        ch_o=ch;
-        cp_o=cp;
-        cv_o=cv;
-
-        n_o=n[p];
-        v_o=v;
-      });
-    }
-  } else {
-    printf("unable to load `dmc.bml`\n");
-  }
-
-#if 0
-  // SMB3:
-  {
-    // kick drum:
-    sampleDescriptors.insert(0x82A9954CEA45D76AULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=36; v=96; });
-    // snare drum:
-    sampleDescriptors.insert(0x5875F05F7B1D6EE7ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=38; v=96; });
-    // tom:
-    sampleDescriptors.insert(0xF82E24ED29B23E6DULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=47 + (p - 0xE); v=96; });
-    // high wood block:
-    sampleDescriptors.insert(0x715DDEF53031FC1BULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=77 - (p - 0xE); v=96; });
-    // timbale:
-    sampleDescriptors.insert(0x14E85FA4D6211223ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=66 - (p - 0xE); v=96; });
-
-    // block explosion long
-    sampleDescriptors.insert(0x530AD3FAABD3E6CDULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=61; v=96; });
-    // block explosion short
-    sampleDescriptors.insert(0x34EAE0720494FA43ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=61; v=96; });
-
-    // fortress timpani hits
-    sampleDescriptors.insert(0x05B216622992F30DULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=41 + (p - 0xE)*2; v=112; });
-  }
-
-  // Super-C:
-  {
-    // kick drum:
-    sampleDescriptors.insert(0x7CF96FBF8992F1B8ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=36; v=96; });
-    // snare drum:
-    sampleDescriptors.insert(0x7CE12344BCC44AC8ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=38; v=96; });
-
-    // toms:
-    sampleDescriptors.insert(0x621CFEA6F56DECB0ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=array<u8[3]>{48,47,45}[0xF-p]; v=112; });
-
-    // orchestra hits:
-    sampleDescriptors.insert(0x479ac6554ae6ff14ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=38+12; v=112; /* (D-2) p=0xD */ });
-    sampleDescriptors.insert(0x82e05ddd4aaaff9aULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=39+12; v=112; /* (D#2) p=0xD */ });
-    sampleDescriptors.insert(0x02e6bcfdd42e1039ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=40+12; v=112; /* (E-2) p=0xD */ });
-    sampleDescriptors.insert(0xb96362a05fb2bae8ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=41+12; v=112; /* (F-2) p=0xD */ });
-    sampleDescriptors.insert(0x64d735a09b5ea750ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=43+12; v=112; /* (G-2) p=0xD */ });
-    sampleDescriptors.insert(0xbbfc22343c6e44b8ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=44+12; v=112; /* (G#2) p=0xD */ });
-    sampleDescriptors.insert(0xe183be8c0e51c7c7ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=45+12; v=112; /* (A-2) p=0xD */ });
-    sampleDescriptors.insert(0x616ed59931f78d52ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=46+12; v=112; /* (A#2) p=0xD */ });
-    sampleDescriptors.insert(0xb050ad75c62b7c7bULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=47+12; v=112; /* (B-2) p=0xD */ });
-    sampleDescriptors.insert(0x1289ec66c4831269ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=10; n=48+12; v=112; /* (C-3) p=0xD */ });
-  }
-
-  // Contra:
-  {
-    // kick drum:
-    sampleDescriptors.insert(0xCDA8A7E459A39D2EULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=36; v=96; });
-    // snare drum:
-    sampleDescriptors.insert(0x2A62B26DD9F0BA73ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){ c=9; n=38; v=96; });
-  }
-  
-  // Fester's Quest:
-  {
-    // slap bass:
-    sampleDescriptors.insert(0x0c18c4a8aa28f924ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=11; v=112;
-      switch (p) {
-        case 0x3: n=29+0; break;
-        case 0x4: n=31+0; break;
-        case 0x7: n=36+0; break;
-        case 0x8: n=38+0; break;
-        case 0xA: n=43+0; break;
-        case 0xC: n=48+0; break;
-        // unknown high note to detect
-        default: n = 72+12; break;
-      }
-    });
-    sampleDescriptors.insert(0x35f1ba1464004391ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=11; v=112;
-      switch (p) {
-        case 0x4: n=30+0; break;
-        case 0x5: n=32+0; break;
-        case 0x6: n=34+0; break;
-        case 0xD: n=51+0; break;
-        // unknown high note to detect
-        default: n = 72+12; break;
-      }
-    });
-    sampleDescriptors.insert(0x130afdd8a57fb3e8ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=11; v=112;
-      switch (p) {
-        case 0x8: n=39+0; break;
-        case 0xB: n=46+0; break;
-        // unknown high note to detect
-        default: n = 72+12; break;
-      }
-    });
-    sampleDescriptors.insert(0xd27417903aa611b5ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=11; v=112;
-      switch (p) {
-        case 0xC: n=50+0; break;
-        // unknown high note to detect
-        default: n = 72+12; break;
-      }
-    });
-
-    // orchestra hits:
-    sampleDescriptors.insert(0x2d1074160f8eba58ULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=10; v=112;
-      switch (p) {
-        case 0x9: n=29+12; break;
-        case 0xB: n=33+12; break;
-        // unknown high note to detect
-        default: n = 72+12; break;
-      }
-    });
-    sampleDescriptors.insert(0xdee92674676cfbdeULL, [](n4 p, u8& c, u8& g, double& n, u8& v){
-      c=10; v=112;
-      switch (p) {
-        case 0xC: n=34+12; break;
-        // unknown high note to detect
-        default: n=72+12; break;
-      }
-    });
-  }
-
-  // one-time function to convert above lambdas into BML output:
-  {
-    Markup::Node list;
-    for (auto pair : sampleDescriptors) {
-      Markup::Node node("sample");
-      u64 h = pair.key;
-      u8  nc = 0;
-      u8  ng = 0;
-      u8  nv = 96;
-      double nn[16];
-
-      for (int p = 0; p < 16; p++) {
-        pair.value(p, nc, ng, nn[p], nv);
-      }
-
-      node.append(std::move(Markup::Node("fnv64a", {"0x", hex(h, 16, '0')})));
-      node.append(std::move(Markup::Node("channel", {nc} )));
-      node.append(std::move(Markup::Node("program", {ng} )));
-      node.append(std::move(Markup::Node("velocity", {nv} )));
-
-      for (int p = 0; p < 16; p++) {
-        node.append(std::move(Markup::Node({"p", hex(p, 1, '0').upcase()}, {nn[p]})));
-      }
-
-      list.append(node);
+//the sample database is loaded on first use and shared for the lifetime of the process.
+//the compiled dmc.db is preferred; dmc.bml is compiled in memory when no dmc.db is available.
+auto APU::DMC::database() -> const DMCSampleDatabase& {
+  static DMCSampleDatabase database;
+  static bool loaded = false;
+  if(!loaded) {
+    loaded = true;
+    if(!database.open({Path::resources(), "dmc.db"})) {
+      database.openMarkup(string::read({Path::resources(), "dmc.bml"}));
     }
-    print(BML::serialize(list));
   }
-#endif
+  return database;
 }
 
 auto APU::DMC::setDMABuffer(n8 data) -> void {
+  apu.catchUp();
+  apu.setDeadline(0);
   dmaBuffer = data;
   dmaBufferValid = true;
   lengthCounter--;
   readAddress++;
 
   if (lengthCounter == 0) {
+    apu.midiUpdate();
     if (loopMode) {
       readAddress = 0x4000 + (addressLatch << 6);
       lengthCounter = (lengthLatch << 4) + 1;
@@ -288,36 +109,72 @@ auto APU::DMC::setDMABuffer(n8 data) -> void {
   }
 }
 
+//returns the FNV-64a hash of the sample contents, which identifies the sample in dmc.bml.
+//hashing reads up to 4081 bytes, so results are cached by the program ROM location the sample is mapped to;
+//the sample's first and last bytes together identify the (at most two) banks it spans.
+//boards that cannot report their mapping instead flush the cache whenever cartridge space is written.
+auto APU::DMC::sampleHash() -> u64 {
+  n16 address = 0x8000 | 0x4000 + (addressLatch << 6);
+  n16 length = (lengthLatch << 4) + 1;
+
+  u64 key;
+  maybe<u32> first = cartridge.mapPRG(address);
+  maybe<u32> last = cartridge.mapPRG(0x8000 | address + length - 1);
+  if(first && last) {
+    key = (u64)lengthLatch << 32 | first();
+  } else {
+    if(sampleHashesGeneration != cartridge.generationPRG) {
+      sampleHashesGeneration = cartridge.generationPRG;
+      sampleHashes.reset();
+    }
+    key = 1ull << 63 | lengthLatch << 8 | addressLatch;
+    last = 0;
+  }
+
+  if(auto cached = sampleHashes.find(key)) {
+    if(cached().last == last()) return cached().hash;
+  }
+
+  apu.midi->telemetry().cacheMisses++;
+
+  // read the bytes of the sample and FNV-64a hash its contents:
+  u64 h = 14695981039346656037ULL; // offset64 from fnv64a
+  while (length-- != 0) {
+    n8 b = cpu.readDebugger(address);
+    address = 0x8000 | address + 1;
+    h ^= (u8)b;
+    h *= 1099511628211ULL;
+  }
+
+  sampleHashes.insert(key, {last(), h});
+  return h;
+}
+
 auto APU::DMC::calculateMidi() -> void {
+  if (m.triggered && clocksSinceStart <= 16) {
+    // wait for the sample to start playing:
+    apu.midiWake(apu.midiCycle + 17 - clocksSinceStart);
+  }
   if (m.triggered && clocksSinceStart > 16) {
     // sample started:
     m.triggered = 0;
 
-    // read the bytes of the sample and FNV-64a hash its contents:
-    n16 a = (0x4000 + (addressLatch << 6));
-    n16 l = (lengthLatch << 4) + 1;
-
-    u64 h = 14695981039346656037ULL; // offset64 from fnv64a
-    while (l-- != 0) {
-      n8 b = cpu.readDebugger(0x8000 | a++);
-      h ^= (u8)b;
-      h *= 1099511628211ULL;
-    }
+    u64 h = sampleHash();
 
     // look up sample mapping based on hash of its contents:
-    auto maybeDesc = sampleDescriptors.find(h);
-    if (maybeDesc) {
-      double n;
-      maybeDesc.get()(period, m.noteChan, m.chanProgram, m.chanVolume, n, m.noteVel);
+    if (auto desc = database().find(h)) {
+      m.noteChan = desc->channel;
+      m.chanProgram = desc->program;
+      m.chanVolume = desc->volume;
+      m.noteVel = desc->velocity;
 
-      m.applyNoteWheel(n);
-
-      //printf("dmc: 0x%016llX: a=%02X, l=%02X, p=%1X found\n", h, (u8)addressLatch, (u8)lengthLatch, (u8)period);
+      m.applyNoteWheel(desc->note[period]);
     } else {
-      printf("dmc: 0x%016llX: a=%02X, l=%02X, p=%1X NOT found\n", h, (u8)addressLatch, (u8)lengthLatch, (u8)period);
+      apu.midi->telemetry().sampleMisses++;
     }
 
-#if 1
+#if 0
+    // enable to dump each unrecognized sample as 16-bit PCM (with a Reaper import file) for authoring dmc.bml:
     {
       auto periodsMapMaybe = samplesMissing.find(h);
       if (!periodsMapMaybe) {
@@ -407,22 +264,22 @@ auto APU::DMC::calculateMidi() -> void {
   m.lastLengthCounter = lengthCounter;
 }
 
-auto APU::DMC::generateMidi(MIDIEmitter& emit) -> void {
+auto APU::DMC::generateMidi() -> void {
   if (m.rateLimit()) return;
 
   if ((m.noteOn != m.lastNoteOn) || (m.noteVel != m.lastVel) || (m.noteNew)) {
     if (m.lastNoteOn != 0) {
       // note off:
-      emit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
+      apu.midiEmit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
       m.lastNoteOn = 0;
     }
     if (m.noteOn != 0 && m.noteVel != 0 || m.noteNew) {
       // emit will prevent redundant updates:
-      emit(0xC0 | m.noteChan, m.chanProgram, 0);
-      emit(0xB0 | m.noteChan, 0x07, m.chanVolume);
+      apu.midiEmit(0xC0 | m.noteChan, m.chanProgram, 0);
+      apu.midiEmit(0xB0 | m.noteChan, 0x07, m.chanVolume);
 
       // note on:
-      emit(0x90 | m.noteChan, m.noteOn, m.noteVel);
+      apu.midiEmit(0x90 | m.noteChan, m.noteOn, m.noteVel);
       m.lastChan = m.noteChan;
       m.lastNoteOn = m.noteOn;
       m.lastVel = m.noteVel;
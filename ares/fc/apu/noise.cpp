@@ -142,12 +142,12 @@ auto APU::Noise::calculateMidi() -> void {
   m.noteVel = v;
 }
 
-auto APU::Noise::generateMidi(MIDIEmitter &emit) -> void {
+auto APU::Noise::generateMidi() -> void {
   if (m.rateLimit()) return;
 
   if (m.lastNoteOn != 0 && m.noteVel == 0 && m.lastVel != 0) {
     // note off when velocity goes to zero:
-    emit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
+    apu.midiEmit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
     dumpMidi(0x80 | m.lastChan, m.lastNoteOn, 0x00);
     m.lastNoteOn = 0;
     m.lastVel = 0;
@@ -156,14 +156,14 @@ auto APU::Noise::generateMidi(MIDIEmitter &emit) -> void {
   if ((m.noteOn != m.lastNoteOn) || (m.noteVel != m.lastVel) || (m.noteNew)) {
     if (m.lastNoteOn != 0) {
       // note off:
-      emit(0x80 | m.noteChan, m.lastNoteOn, 0x00);
+      apu.midiEmit(0x80 | m.noteChan, m.lastNoteOn, 0x00);
       dumpMidi(0x80 | m.noteChan, m.lastNoteOn, 0x00);
       m.lastNoteOn = 0;
       m.lastVel = 0;
     }
     if (m.noteOn != 0 && m.noteVel != 0 || m.noteNew) {
       // note on:
-      emit(0x90 | m.noteChan, m.noteOn, m.noteVel);
+      apu.midiEmit(0x90 | m.noteChan, m.noteOn, m.noteVel);
       dumpMidi(0x90 | m.noteChan, m.noteOn, m.noteVel);
       m.lastChan = m.noteChan;
       m.lastNoteOn = m.noteOn;
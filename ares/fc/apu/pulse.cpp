@@ -32,8 +32,8 @@ auto APU::Pulse::power(bool reset) -> void {
 
 auto APU::Pulse::calculateMidi() -> void {
   // don't sample the period too early when writes are spread across two registers and multiple clocks between:
-  if (m.periodWriteCountdown > 0) {
-    m.periodWriteCountdown--;
+  if (apu.midiCycle < m.periodWriteCycle) {
+    apu.midiWake(m.periodWriteCycle);
     return;
   }
 
@@ -42,14 +42,11 @@ auto APU::Pulse::calculateMidi() -> void {
   if (!sweep.checkPeriod() || length.counter == 0 || sweep.pulsePeriod < 0x008) {
     // silence:
     m.noteOn = 0;
-    m.clocksSinceNoteOn = 0;
     return;
   }
 
   // audible note:
-  double f = 1'789'773.0 / (16.0 * ((double)sweep.pulsePeriod + 1.0));
-  // A0 = midi note 21; 27.5Hz
-  double n = 12.0 * log2(f / 27.5) + 21.0;
+  double n = apu.midiPeriodNote[sweep.pulsePeriod];
   if (n > 127) {
     return;
   }
@@ -69,17 +66,17 @@ auto APU::Pulse::calculateMidi() -> void {
   m.noteVel = v;
 
   // rate-limit duty changes:
-  if (m.clocksSinceNoteOn > 0) m.clocksSinceNoteOn++;
   if (currNoteOn == 0 || m.noteOn != currNoteOn) {
     // first time note on:
     m.noteDuty = duty;
     m.noteChan = m.chans[m.noteDuty];
-    m.clocksSinceNoteOn = 1;
+    m.noteOnCycle = apu.midiCycle;
   }
 
-  if (m.clocksSinceNoteOn < 131072) {
+  if (apu.midiCycle - m.noteOnCycle < 131072) {
     // maintain initial duty but keep track of latest duty so we can switch once:
     m.noteDuty = duty;
+    if (m.chans[m.noteDuty] != m.noteChan) apu.midiWake(m.noteOnCycle + 131072);
   } else {
     // we're allowed only one duty change after the initial note on:
     m.noteChan = m.chans[m.noteDuty];
@@ -87,14 +84,14 @@ auto APU::Pulse::calculateMidi() -> void {
 
 }
 
-auto APU::Pulse::generateMidi(MIDIEmitter &emit) -> void {
+auto APU::Pulse::generateMidi() -> void {
   if (m.rateLimit()) return;
 
   u8 lastChan = m.lastChan;
 
   if (m.lastNoteOn != 0 && m.noteVel == 0 && m.lastVel != 0) {
     // note off when velocity goes to zero:
-    emit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
+    apu.midiEmit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
     m.lastNoteOn = 0;
     m.lastFreq = 0;
     m.lastVel = 0;
@@ -103,13 +100,13 @@ auto APU::Pulse::generateMidi(MIDIEmitter &emit) -> void {
   if (m.noteOn != m.lastNoteOn || m.noteChan != m.lastChan) {
     if (m.lastNoteOn != 0) {
       // note off:
-      emit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
+      apu.midiEmit(0x80 | m.lastChan, m.lastNoteOn, 0x00);
       m.lastNoteOn = 0;
       m.lastFreq = 0;
     }
     if (m.noteOn != 0 && m.noteVel != 0) {
       // note on:
-      emit(0x90 | m.noteChan, m.noteOn, 96);
+      apu.midiEmit(0x90 | m.noteChan, m.noteOn, 96);
       m.lastNoteOn = m.noteOn;
       m.lastChan = m.noteChan;
       m.lastFreq = m.noteFreq;
@@ -119,7 +116,7 @@ auto APU::Pulse::generateMidi(MIDIEmitter &emit) -> void {
   if (m.noteOn != 0 && m.noteVel != 0) {
     // adjust pitch bend:
     if (m.noteWheel != m.lastWheel || m.noteChan != lastChan) {
-      emit(0xE0 | m.noteChan, m.noteWheel & 0x7F, (m.noteWheel >> 7) & 0x7F);
+      apu.midiEmit(0xE0 | m.noteChan, m.noteWheel & 0x7F, (m.noteWheel >> 7) & 0x7F);
       m.lastWheel = m.noteWheel;
       m.lastFreq = m.noteFreq;
     }
@@ -127,7 +124,7 @@ auto APU::Pulse::generateMidi(MIDIEmitter &emit) -> void {
     // adjust channel volumes:
     if (m.noteVel != m.lastVel || m.noteChan != lastChan) {
       // channel volume:
-      emit(0xB0 | m.noteChan, 0x07, m.noteVel);
+      apu.midiEmit(0xB0 | m.noteChan, 0x07, m.noteVel);
       m.lastVel = m.noteVel;
     }
   }
@@ -1,10 +1,56 @@
 auto APU::serialize(serializer& s) -> void {
+  //the MIDI device still holds what was sent before the state load, whatever the loaded state believes:
+  MIDIDevice device;
+  if(s.reading()) device = midiDevice();
+
   Thread::serialize(s);
   s(pulse1);
   s(pulse2);
   s(triangle);
+  s(noise);
   s(dmc);
   s(frame);
+
+  s(midiCycle);
+  s(midiDue);
+  s(chanProgram);
+  s(chanCC);
+  s(chanWheel);
+
+  if(s.reading()) {
+    midi->setClock(clock());
+    midiReconcile(device);
+    midiUpdate();
+  }
+}
+
+auto APU::MidiState::serialize(serializer& s) -> void {
+  s(noteNew);
+  s(noteOn);
+  s(noteChan);
+  s(noteVel);
+  s(noteWheel);
+  s(noteFreq);
+  s(noteDuty);
+  s(noteOnCycle);
+  s(chanProgram);
+  s(chanVolume);
+  s(lastNoteOn);
+  s(lastChan);
+  s(lastVel);
+  s(lastWheel);
+  s(lastFreq);
+  s(periodWriteCycle);
+  s(lastPeriod);
+  s(lastCycleVolume);
+  s(lastAddressLatch);
+  s(lastLengthLatch);
+  s(lastLengthCounter);
+  s(triggered);
+  s(triggeredStop);
+  s(chans);
+  s(chanVel);
+  s(limitCycle);
 }
 
 auto APU::Length::serialize(serializer& s) -> void {
@@ -39,6 +85,7 @@ auto APU::Sweep::serialize(serializer& s) -> void {
 }
 
 auto APU::Pulse::serialize(serializer& s) -> void {
+  s(m);
   s(envelope);
   s(sweep);
   s(length);
@@ -49,6 +96,7 @@ auto APU::Pulse::serialize(serializer& s) -> void {
 }
 
 auto APU::Triangle::serialize(serializer& s) -> void {
+  s(m);
   s(length);
   s(periodCounter);
   s(linearLength);
@@ -59,6 +107,7 @@ auto APU::Triangle::serialize(serializer& s) -> void {
 }
 
 auto APU::Noise::serialize(serializer& s) -> void {
+  s(m);
   s(envelope);
   s(length);
   s(periodCounter);
@@ -68,6 +117,7 @@ auto APU::Noise::serialize(serializer& s) -> void {
 }
 
 auto APU::DMC::serialize(serializer& s) -> void {
+  s(m);
   s(lengthCounter);
   s(periodCounter);
   s(irqPending);
@@ -34,8 +34,8 @@ auto APU::Triangle::power(bool reset) -> void {
 
 auto APU::Triangle::calculateMidi() -> void {
   // don't sample the period too early when writes are spread across two registers and multiple clocks between:
-  if (m.periodWriteCountdown > 0) {
-    m.periodWriteCountdown--;
+  if (apu.midiCycle < m.periodWriteCycle) {
+    apu.midiWake(m.periodWriteCycle);
     return;
   }
 
@@ -52,9 +52,8 @@ auto APU::Triangle::calculateMidi() -> void {
 
   // audible note:
 
-  double f = 1'789'773.0 / (32.0 * ((double)period + 1.0));
-  // A0 = midi note 21; 27.5Hz
-  double n = 12.0 * log2(f / 27.5) + 21.0;
+  // the triangle channel sounds an octave below a pulse channel of the same period:
+  double n = apu.midiPeriodNote[period] - 12.0;
   if (n > 127) {
     return;
   }
@@ -65,19 +64,19 @@ auto APU::Triangle::calculateMidi() -> void {
   m.noteVel = v;
 }
 
-auto APU::Triangle::generateMidi(MIDIEmitter &emit) -> void {
+auto APU::Triangle::generateMidi() -> void {
   if (m.rateLimit()) return;
 
   if (m.noteOn != m.lastNoteOn) {
     if (m.lastNoteOn != 0) {
       // note off:
-      emit(0x80 | m.noteChan, m.lastNoteOn, 0x00);
+      apu.midiEmit(0x80 | m.noteChan, m.lastNoteOn, 0x00);
       m.lastNoteOn = 0;
       m.lastFreq = 0;
     }
     if (m.noteOn != 0) {
       // note on:
-      emit(0x90 | m.noteChan, m.noteOn, 96);
+      apu.midiEmit(0x90 | m.noteChan, m.noteOn, 96);
       m.lastNoteOn = m.noteOn;
       m.lastChan = m.noteChan;
       m.lastFreq = m.noteFreq;
@@ -87,7 +86,7 @@ auto APU::Triangle::generateMidi(MIDIEmitter &emit) -> void {
   if (m.noteOn != 0) {
     // adjust pitch bend:
     if (m.noteWheel != m.lastWheel) {
-      emit(0xE0 | m.noteChan, m.noteWheel & 0x7F, (m.noteWheel >> 7) & 0x7F);
+      apu.midiEmit(0xE0 | m.noteChan, m.noteWheel & 0x7F, (m.noteWheel >> 7) & 0x7F);
       m.lastWheel = m.noteWheel;
       m.lastFreq = m.noteFreq;
     }
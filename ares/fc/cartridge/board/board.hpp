@@ -19,6 +19,10 @@ struct Interface {
   virtual auto readPRG(n32 address, n8 data) -> n8 { return data; }
   virtual auto writePRG(n32 address, n8 data) -> void {}
 
+  //returns the program ROM offset that a CPU address ($8000-ffff) is currently mapped to.
+  //boards that do not implement this are assumed to remap on any write to cartridge space.
+  virtual auto mapPRG(n16 address) -> maybe<u32> { return nothing; }
+
   virtual auto readCHR(n32 address, n8 data) -> n8 { return data; }
   virtual auto writeCHR(n32 address, n8 data) -> void {}
 
@@ -35,6 +35,10 @@ struct HVC_AxROM : Interface {
     return programROM.read(programBank << 15 | (n15)address);
   }
 
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return (programBank << 15 | (n15)address) & programROM.mask();
+  }
+
   auto writePRG(n32 address, n8 data) -> void override {
     if(address < 0x8000) return;
     programBank = data.bit(0,3);
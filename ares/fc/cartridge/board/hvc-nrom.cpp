@@ -31,6 +31,10 @@ struct HVC_NROM : Interface {
     return programROM.read(address);
   }
 
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return (n15)address & programROM.mask();
+  }
+
   auto writePRG(n32 address, n8 data) -> void override {
     if(address < 0x6000) return;
     if(address < 0x8000 && !programRAM) return;
@@ -147,6 +147,10 @@ struct HVC_SxROM : Interface {  //MMC1
     return data;
   }
 
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return addressProgramROM(address) & programROM.mask();
+  }
+
   auto writePRG(n32 address, n8 data) -> void override {
     if((address & 0xe000) == 0x6000) {
       if(revision == Revision::SNROM) {
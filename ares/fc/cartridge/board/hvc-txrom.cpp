@@ -75,6 +75,14 @@ struct HVC_TxROM : Interface {  //MMC3
       return programRAM.read((n13)address);
     }
 
+    return programROM.read(addressProgramROM(address));
+  }
+
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return addressProgramROM(address) & programROM.mask();
+  }
+
+  auto addressProgramROM(n32 address) -> n32 {
     n6 bank;
     switch(address >> 13 & 3) {
     case 0: bank = (programMode == 0 ? programBank[0] : (n6)0x3e); break;
@@ -91,7 +99,7 @@ struct HVC_TxROM : Interface {  //MMC3
       n1 a16 = (address.bit(16) & outerBank.bit(2)) | (outerBank.bit(1) & outerBank.bit(0));
       address = outerBank.bit(2) << 17 | a16 << 16 | (n16)address;
     }
-    return programROM.read(address);
+    return address;
   }
 
   auto writePRG(n32 address, n8 data) -> void override {
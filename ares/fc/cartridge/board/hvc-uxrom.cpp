@@ -38,12 +38,20 @@ struct HVC_UxROM : Interface {
     if(address < 0x6000) return data;
     if(address < 0x8000 && !programRAM) return data;
     if(address < 0x8000) return programRAM.read(address);
+    return programROM.read(addressProgramROM(address));
+  }
+
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return addressProgramROM(address) & programROM.mask();
+  }
+
+  auto addressProgramROM(n32 address) -> n32 {
     n8 bank;
     switch(address >> 14 & 1) {
     case 0: bank = (revision == Revision::UNROMA ? (n8)0x00 : programBank); break;
     case 1: bank = (revision == Revision::UNROMA ? programBank : (n8)0xff); break;
     }
-    return programROM.read(bank << 14 | (n14)address);
+    return bank << 14 | (n14)address;
   }
 
   auto writePRG(n32 address, n8 data) -> void override {
@@ -60,9 +60,14 @@ auto Cartridge::readPRG(n32 address, n8 data) -> n8 {
 }
 
 auto Cartridge::writePRG(n32 address, n8 data) -> void {
+  if(address >= 0x4020) generationPRG++;
   return board->writePRG(address, data);
 }
 
+auto Cartridge::mapPRG(n16 address) -> maybe<u32> {
+  return board->mapPRG(address);
+}
+
 auto Cartridge::readCHR(n32 address, n8 data) -> n8 {
   return board->readCHR(address, data);
 }
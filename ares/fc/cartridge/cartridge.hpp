@@ -26,11 +26,15 @@ struct Cartridge : Thread {
     string region;
   } information;
 
+  //incremented whenever cartridge space may have been remapped or rewritten
+  u32 generationPRG = 0;
+
 //privileged:
   unique_pointer<Board::Interface> board;
 
   auto readPRG(n32 address, n8 data) -> n8;
   auto writePRG(n32 address, n8 data) -> void;
+  auto mapPRG(n16 address) -> maybe<u32>;
 
   auto readCHR(n32 address, n8 data = 0x00) -> n8;
   auto writeCHR(n32 address, n8 data) -> void;
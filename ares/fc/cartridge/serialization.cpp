@@ -1,4 +1,5 @@
 auto Cartridge::serialize(serializer& s) -> void {
   Thread::serialize(s);
   if(board) s(*board);
+  if(s.reading()) generationPRG++;
 }
@@ -111,6 +111,7 @@ auto PPU::frame() -> void {
   }
 
   screen->frame();
+  apu.midiFrame();
   scheduler.exit(Event::Frame);
 }
 
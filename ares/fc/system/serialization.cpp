@@ -1,8 +1,13 @@
-static const string SerializerVersion = "v148";
+static const string SerializerVersion = "v148.1";
 
 auto System::serialize(bool synchronize) -> serializer {
-  if(synchronize) scheduler.enter(Scheduler::Mode::Synchronize);
   serializer s;
+  serializeTo(s, synchronize);
+  return s;
+}
+
+auto System::serializeTo(serializer& s, bool synchronize) -> void {
+  if(synchronize) scheduler.enter(Scheduler::Mode::Synchronize);
 
   u32  signature = SerializerSignature;
   char version[16] = {};
@@ -15,7 +20,6 @@ auto System::serialize(bool synchronize) -> serializer {
   s(description);
 
   serialize(s, synchronize);
-  return s;
 }
 
 auto System::unserialize(serializer& s) -> bool {
@@ -67,6 +67,7 @@ auto System::load(Node::System& root, string name) -> bool {
   node->setSave({&System::save, this});
   node->setUnload({&System::unload, this});
   node->setSerialize({&System::serialize, this});
+  node->setSerializeTo({&System::serializeTo, this});
   node->setUnserialize({&System::unserialize, this});
   root = node;
 
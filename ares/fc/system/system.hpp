@@ -30,6 +30,7 @@ struct System {
 
   //serialization.cpp
   auto serialize(bool synchronize) -> serializer;
+  auto serializeTo(serializer&, bool synchronize) -> void;
   auto unserialize(serializer&) -> bool;
 
 private:
@@ -10,7 +10,7 @@ auto M32X::readExternal(n1 upper, n1 lower, n24 address, n16 data) -> n16 {
   if(address >= 0x840000 && address <= 0x87ffff) {
     if(vdp.framebufferAccess) return data;
     if(vdp.framebufferEngaged()) { debug(unusual, "[32X FB] 68k read while FEN==1"); return data; } // wait instead?
-    return vdp.bbram[address >> 1 & 0xffff];
+    return vdp.bbram.read(address >> 1);
   }
 
   if(address >= 0x880000 && address <= 0x8fffff) {
@@ -25,7 +25,7 @@ auto M32X::readInternal(n1 upper, n1 lower, n32 address, n16 data) -> n16 {
     if(!vdp.framebufferAccess) return data;
     if(vdp.framebufferEngaged()) { debug(unusual, "[32X FB] SH2 read while FEN==1"); return data; } // wait instead?
     if(shm.active()) shm.internalStep(5); if(shs.active()) shs.internalStep(5);
-    return vdp.bbram[address >> 1 & 0xffff];
+    return vdp.bbram.read(address >> 1);
   }
 
   if(address >= 0x0600'0000 && address <= 0x0603'ffff) {
@@ -79,8 +79,17 @@ struct M32X {
     maybe<M32X&> self;
     Memory::Writable<n16> dram;
     Memory::Writable<n16> cram;
-    array_span<n16> fbram;  //VDP-side active DRAM bank
-    array_span<n16> bbram;  //CPU-side active DRAM bank
+
+    //a 64KB bank of DRAM: writes go through dram, so that they are tracked for serialization
+    struct Bank {
+      auto read(u32 address) const -> n16 { return dram->read(base | address & 0xffff); }
+      auto operator[](u32 address) -> n16& { return (*dram)[base | address & 0xffff]; }
+
+      Memory::Writable<n16>* dram = nullptr;
+      u32 base = 0;
+    };
+    Bank fbram;  //VDP-side active DRAM bank
+    Bank bbram;  //CPU-side active DRAM bank
 
     struct Debugger {
       //debugger.cpp
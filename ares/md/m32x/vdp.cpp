@@ -38,25 +38,25 @@ auto M32X::VDP::scanline(u32 pixels[1280], u32 y) -> void {
 }
 
 auto M32X::VDP::scanlineMode1(u32 pixels[1280], u32 y) -> void {
-  u16 address = fbram[y];
+  u16 address = fbram.read(y);
   for(u32 x : range(320)) {
-    u8 color = fbram[address + (x + latch.dotshift >> 1) & 0xffff].byte(!(x + latch.dotshift & 1));
+    u8 color = fbram.read(address + (x + latch.dotshift >> 1) & 0xffff).byte(!(x + latch.dotshift & 1));
     plot(&pixels[x * 4], cram[color]);
   }
 }
 
 auto M32X::VDP::scanlineMode2(u32 pixels[1280], u32 y) -> void {
-  u16 address = fbram[y];
+  u16 address = fbram.read(y);
   for(u32 x : range(320)) {
-    u16 pixel = fbram[address++ & 0xffff];
+    u16 pixel = fbram.read(address++ & 0xffff);
     plot(&pixels[x * 4], pixel);
   }
 }
 
 auto M32X::VDP::scanlineMode3(u32 pixels[1280], u32 y) -> void {
-  u16 address = fbram[y];
+  u16 address = fbram.read(y);
   for(u32 x = 0; x < 320;) {
-    u16 word  = fbram[address++ & 0xffff];
+    u16 word  = fbram.read(address++ & 0xffff);
     u8 length = word >> 8;
     u8 color  = word >> 0;
     u16 pixel = cram[color];
@@ -97,8 +97,8 @@ auto M32X::VDP::selectFramebuffer(n1 select) -> void {
   if(!vblank && latch.mode) return;
 
   framebufferActive = select;
-  fbram = {dram.data() + 0x10000 * (select == 0), 0x10000};
-  bbram = {dram.data() + 0x10000 * (select == 1), 0x10000};
+  fbram = {&dram, 0x10000u * (select == 0)};
+  bbram = {&dram, 0x10000u * (select == 1)};
 }
 
 // back buffer access
@@ -114,7 +114,7 @@ auto CPU::instruction() -> void {
     if(vaddrAlignedError<Word>(access.vaddr, false)) return;
     auto block = recompiler.block(ipu.pc, access.paddr, GDB::server.hasBreakpoints());
     if(block) {
-      block->execute(*this);
+      recompiler.execute(block);
       return;
     } 
   }
@@ -303,6 +303,9 @@ struct CPU : Thread {
   auto jitFetch(u64 vaddr, u32 addr) -> void {
     icache.jitFetch(vaddr, addr, *this);
   }
+  auto jitDispatch() -> u8* {
+    return recompiler.dispatch();
+  }
   template<u32 Size> auto busWrite(u32 address, u64 data) -> void;
   template<u32 Size> auto busRead(u32 address) -> u64;
   template<u32 Size> auto busWriteBurst(u32 address, u32 *data) -> void;
@@ -875,55 +878,112 @@ struct CPU : Thread {
     CPU& self;
     Recompiler(CPU& self) : self(self), generic(allocator) {}
 
+    struct Link;
+
     struct Block {
       auto execute(CPU& self) -> void {
         ((void (*)(CPU*, r64*, r64*))code)(&self, &self.ipu.r[16], &self.fpu.r[16]);
       }
 
       u8* code;
+      u8* entry;       //past the prologue: where linked blocks jump to
+      Link* links;     //exits of other blocks that currently jump here
+      u32 address;     //physical address of the first instruction
+      u32 size;        //in bytes; blocks never cross a pool, so each lies within one page
+      Block* sibling;  //the next block in the same page
+    };
+
+    //a block exit that continues at a known address.
+    //its jump can be patched to enter the block at that address directly, bypassing the dispatcher.
+    struct Link {
+      u64 target;
+      u8* jump;    //the patchable jump
+      u8* stub;    //its original destination, which returns to the dispatcher
+      Link* next;  //the next link into the same block
     };
 
     struct Pool {
       Block* blocks[1 << 6];
     };
 
+    //the blocks compiled from a 4 KiB page of memory, so that writes can find the blocks they overwrite
+    struct Page {
+      Block* blocks;
+      u32 code[32];  //one bit for each word covered by a block
+    };
+
+    //linked blocks run one after another until this many clocks have been spent.
+    //the other components only catch up as the run ends, or where an instruction observes them (see charge()).
+    static constexpr s64 Quantum = 512;
+
     auto reset() -> void {
       pools.reallocate(1 << 21);  //2_MiB * sizeof(void*) == 16_MiB
       pools.fill();
+      pages.reallocate(1 << 17);  //128_KiB * sizeof(void*) == 1_MiB
+      pages.fill();
+      unlinked = nullptr;
     }
 
-    auto invalidate(u32 address) -> void {
-      /* FIXME: Recompiler shouldn't be so aggressive with pool eviction
-       * Sometimes there are overlapping blocks, so clearing just one block
-       * isn't sufficient and causes some games to crash (Jet Force Gemini)
-       * the recompiler needs to be smarter with block tracking
-       * Until then, clear the entire pool and live with the performance hit.
-      */
-      #if 1
-      invalidatePool(address);
-      #else
-      auto pool = pools[address >> 8 & 0x1fffff];
-      if(!pool) return;
-      memory::jitprotect(false);
-      pool->blocks[address >> 2 & 0x3f] = nullptr;
-      memory::jitprotect(true);
-      #endif
+    //ends the current run of linked blocks at the next block exit, eg: so that an interrupt can be taken
+    auto stop() -> void {
+      allowance -= budget;
+      budget = 0;
     }
 
-    auto invalidatePool(u32 address) -> void {
-      pools[address >> 8 & 0x1fffff] = nullptr;
+    auto charge() -> void;
+
+    //blocks overlap (a block may start at any instruction of another), so every block covering the word is removed
+    auto invalidate(u32 address) -> void {
+      address &= 0x1fff'ffff;
+      auto page = pages[address >> 12];
+      if(!page) return;
+      u32 word = address >> 2 & 0x3ff;
+      if(!(page->code[word >> 5] >> (word & 31) & 1)) return;
+      invalidate(*page, address & ~3, 4);
     }
 
     auto invalidateRange(u32 address, u32 length) -> void {
-      for (u32 s = 0; s < length; s += 256)
-        invalidatePool(address + s);
-      invalidatePool(address + length - 1);
+      if(!length) return;
+      address &= 0x1fff'ffff;
+      u32 last = min(address + length - 1, 0x1fff'ffffu);
+      for(u32 index = address >> 12; index <= last >> 12; index++) {
+        if(auto page = pages[index]) invalidate(*page, address, last - address + 1);
+      }
     }
 
     auto pool(u32 address) -> Pool*;
+    auto page(u32 address) -> Page*;
+    auto mark(Page& page, Block& block) -> void;
+    auto invalidate(Page& page, u32 address, u32 length) -> void;
     auto block(u64 vaddr, u32 address, bool singleInstruction = false) -> Block*;
+    auto execute(Block* block) -> void;
+    auto dispatch() -> u8*;
+    auto linkable(u64 vaddr) const -> bool;
+    auto link(Link& link, Block& block) -> void;
+    auto unlink(Block& block) -> void;
 
     auto emit(u64 vaddr, u32 address, bool singleInstruction = false) -> Block*;
+    auto emitFetch(u64 vaddr, u32 address) -> void;
+    auto allocate(u32 address, bool singleInstruction) -> void;
+    auto readGPR(u32 n) -> op_base;
+    auto readGPR32(u32 n) -> op_base;
+    auto writeGPR(u32 n) -> op_base;
+    auto sync() -> void;
+    auto emitSpent() -> void;
+
+    //called functions may read or write any guest state in memory:
+    //write back what the block keeps elsewhere first, and reload guest registers afterward.
+    //they may also charge the clocks spent so far (see charge()), so the block records how many those are.
+    template<typename... P> auto call(P... p) -> void {
+      sync();
+      emitSpent();
+      generic::call(p...);
+      cacheForget();
+      calls++;
+    }
+    auto branchTarget(u64 vaddr, u32 instruction) const -> u64;
+    auto branches(u32 instruction) const -> bool;
+    auto branchLikely(u32 instruction) const -> bool;
     auto emitZeroClear(u32 n) -> void;
     auto emitEXECUTE(u32 instruction) -> bool;
     auto emitSPECIAL(u32 instruction) -> bool;
@@ -936,6 +996,20 @@ struct CPU : Thread {
     bool callInstructionPrologue = false;
     bump_allocator allocator;
     vector<Pool*> pools;
+    vector<Page*> pages;
+    s64 budget = 0;             //clocks left before control returns to the dispatcher
+    s64 allowance = 0;          //the budget this dispatch started with, less the clocks charged early
+    u32 spent = 0;              //clocks of the running block before the instruction it is executing
+    Link* unlinked = nullptr;   //the exit that last returned to the dispatcher
+
+    //state of the block being emitted that is known at compile time, and not yet stored to memory
+    struct Pending {
+      maybe<u64> pc;     //pipeline.pc; pipeline.nextpc follows it
+      maybe<u64> ipuPc;  //ipu.pc
+      bool zero = false; //ipu.r[0] was written, and must be cleared
+    } pending;
+    u32 calls = 0;       //calls emitted so far
+    u32 clocks = 0;      //clocks of the instructions emitted so far
   } recompiler{*this};
 
   struct Disassembler {
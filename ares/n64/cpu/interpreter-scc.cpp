@@ -134,6 +134,11 @@ auto CPU::getControlRegister(n5 index) -> u64 {
 }
 
 auto CPU::setControlRegister(n5 index, n64 data) -> void {
+  //interrupts may have been enabled or raised
+  if constexpr(Accuracy::CPU::Recompiler) {
+    if(index == 9 || index == 11) recompiler.charge();  //count, compare
+    recompiler.stop();
+  }
   scc.latch = data;
   //read-only variables are defined but commented out for documentation purposes
   switch(index) {
@@ -273,6 +278,7 @@ auto CPU::DMFC0(r64& rt, u8 rd) -> void {
     if(!scc.status.enable.coprocessor0) return exception.coprocessor0();
     if(context.bits == 32) return exception.reservedInstruction();
   }
+  if constexpr(Accuracy::CPU::Recompiler) if(rd == 9 || rd == 13) recompiler.charge();  //count, cause
   rt.u64 = getControlRegister(rd);
 }
 
@@ -298,12 +304,15 @@ auto CPU::ERET() -> void {
   pipeline.exception();
   scc.llbit = 0;
   context.setMode();
+  //interrupts may have been enabled, or kernel mode left
+  if constexpr(Accuracy::CPU::Recompiler) recompiler.stop();
 }
 
 auto CPU::MFC0(r64& rt, u8 rd) -> void {
   if(!context.kernelMode()) {
     if(!scc.status.enable.coprocessor0) return exception.coprocessor0();
   }
+  if constexpr(Accuracy::CPU::Recompiler) if(rd == 9 || rd == 13) recompiler.charge();  //count, cause
   rt.u64 = s32(getControlRegister(rd));
 }
 
@@ -158,6 +158,8 @@ auto CPU::read(PhysAccess access) -> maybe<u64> {
   if(!access) return nothing;
   GDB::server.reportMemRead(access.vaddr, Size);
   if(access.cache) return dcache.read<Size>(access.vaddr, access.paddr);
+  //device registers reflect how far the other components have run
+  if constexpr(Accuracy::CPU::Recompiler) if(access.paddr >= 0x0400'0000) recompiler.charge();
   return busRead<Size>(access.paddr);
 }
 
@@ -175,6 +177,7 @@ auto CPU::write(PhysAccess access, u64 data) -> bool {
   if(!access) return false;
   GDB::server.reportMemWrite(access.vaddr, Size);
   if(access.cache) return dcache.write<Size>(access.vaddr, access.paddr, data), true;
+  if constexpr(Accuracy::CPU::Recompiler) if(access.paddr >= 0x0400'0000) recompiler.charge();
   return busWrite<Size>(access.paddr, data), true;
 }
 
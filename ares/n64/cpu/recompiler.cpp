@@ -9,19 +9,166 @@ auto CPU::Recompiler::pool(u32 address) -> Pool* {
   return pool;
 }
 
+auto CPU::Recompiler::page(u32 address) -> Page* {
+  auto& page = pages[address >> 12 & 0x1ffff];
+  if(!page) {
+    page = (Page*)allocator.acquire(sizeof(Page));
+    memory::jitprotect(false);
+    *page = {};
+    memory::jitprotect(true);
+  }
+  return page;
+}
+
 auto CPU::Recompiler::block(u64 vaddr, u32 address, bool singleInstruction) -> Block* {
   if(auto block = pool(address)->blocks[address >> 2 & 0x3f]) return block;
   auto block = emit(vaddr, address, singleInstruction);
   if(block) {
-    pool(address)->blocks[address >> 2 & 0x3f] = block;
+    //emit() may have flushed the allocator, so the pool and page are looked up afterward
+    auto pool = this->pool(address);
+    auto page = this->page(address);
+    memory::jitprotect(false);
+    pool->blocks[address >> 2 & 0x3f] = block;
+    block->sibling = page->blocks;
+    page->blocks = block;
+    mark(*page, *block);
     memory::jitprotect(true);
   }
   return block;
 }
 
+//sets the bits of the words that the block was compiled from
+auto CPU::Recompiler::mark(Page& page, Block& block) -> void {
+  u32 first = block.address >> 2 & 0x3ff;
+  for(u32 word = first; word < first + block.size / 4; word++) {
+    page.code[word >> 5] |= 1 << (word & 31);
+  }
+}
+
+//removes every block in the page compiled from any of the bytes in [address, address + length)
+auto CPU::Recompiler::invalidate(Page& page, u32 address, u32 length) -> void {
+  u64 lo = address, hi = (u64)address + length;
+  memory::jitprotect(false);
+  for(auto& word : page.code) word = 0;
+  for(auto link = &page.blocks; *link;) {
+    auto block = *link;
+    if(block->address < hi && block->address + block->size > lo) {
+      *link = block->sibling;
+      unlink(*block);
+      pools[block->address >> 8 & 0x1fffff]->blocks[block->address >> 2 & 0x3f] = nullptr;
+      continue;
+    }
+    mark(page, *block);
+    link = &block->sibling;
+  }
+  memory::jitprotect(true);
+}
+
+auto CPU::Recompiler::execute(Block* block) -> void {
+  //the exit that returned to the dispatcher always continues here, so it can jump here directly from now on
+  if(unlinked && unlinked->target == self.ipu.pc && linkable(self.ipu.pc)) link(*unlinked, *block);
+  unlinked = nullptr;
+
+  //each block charges its clocks to the budget as it exits, and only follows links while some remains.
+  //a budget of one clock runs a single block, as the debugger needs to see every block entered.
+  bool chain = self.context.kernelMode() && !GDB::server.hasClient();
+  budget = allowance = chain ? Quantum : 1;
+  block->execute(self);
+  self.step(allowance - budget);
+  budget = allowance = 0;
+  spent = 0;
+}
+
+//linked blocks only charge their clocks to the CPU as the run ends, and the other components (and Count)
+//only catch up with the CPU as it synchronizes; until then, they lag behind by up to a whole run.
+//reads of Count and Cause, and accesses to device registers, call this first, so that they observe the same
+//time as they would if every block returned to the dispatcher; it costs a synchronize() each, which is rare.
+//an interrupt raised by catching up is taken as the block exits, rather than at the end of the run.
+auto CPU::Recompiler::charge() -> void {
+  s64 clocks = allowance - budget + spent;
+  if(clocks <= 0) return;  //not running a block, or nothing left to charge
+  self.step(clocks);
+  auto interruptPending = self.scc.cause.interruptPending;
+  self.synchronize();
+  //the clocks up to here are paid: the block exit still subtracts them from the budget, but not from the allowance
+  allowance -= clocks;
+  if(self.scc.cause.interruptPending != interruptPending) stop();
+}
+
+//finds the block that an exit with an unknown target continues at, so that it can be entered directly
+auto CPU::Recompiler::dispatch() -> u8* {
+  u64 vaddr = self.ipu.pc;
+  if(vaddr & 3 || !linkable(vaddr)) return nullptr;
+  u32 address = vaddr & 0x1fff'ffff;
+  auto pool = pools[address >> 8 & 0x1fffff];
+  if(!pool) return nullptr;
+  auto block = pool->blocks[address >> 2 & 0x3f];
+  return block ? block->entry : nullptr;
+}
+
+//links only target kseg0, as its mapping cannot change while the block there remains valid.
+//blocks only run linked in kernel mode, so kseg0 is always accessible when a link is followed.
+auto CPU::Recompiler::linkable(u64 vaddr) const -> bool {
+  return (s64)vaddr >> 29 == -4 && self.context.kernelMode() && !GDB::server.hasClient();
+}
+
+auto CPU::Recompiler::link(Link& link, Block& block) -> void {
+  memory::jitprotect(false);
+  sljit_set_jump_addr((sljit_uw)link.jump, (sljit_uw)block.entry, 0);
+  link.next = block.links;
+  block.links = &link;
+  memory::jitprotect(true);
+}
+
+//restores every exit that jumps into the block to return to the dispatcher instead.
+//the caller must disable write protection.
+auto CPU::Recompiler::unlink(Block& block) -> void {
+  for(auto link = block.links; link; link = link->next) {
+    sljit_set_jump_addr((sljit_uw)link->jump, (sljit_uw)link->stub, 0);
+  }
+  block.links = nullptr;
+}
+
+//returns where a branch or jump continues when taken, or zero if that is not known until it runs
+auto CPU::Recompiler::branchTarget(u64 vaddr, u32 instruction) const -> u64 {
+  u64 delaySlot = vaddr + 4;
+  u64 relative = delaySlot + (s16(instruction) << 2);
+  switch(instruction >> 26) {
+  case 0x01: return (instruction >> 16 & 0x0c) == 0x00 ? relative : 0;  //BLTZ, BGEZ, BLTZAL, BGEZAL and their likely forms
+  case 0x02: case 0x03: return delaySlot & 0xffff'ffff'f000'0000 | (instruction & 0x03ff'ffff) << 2;  //J, JAL
+  case 0x04: case 0x05: case 0x06: case 0x07: return relative;  //BEQ, BNE, BLEZ, BGTZ
+  case 0x14: case 0x15: case 0x16: case 0x17: return relative;  //BEQL, BNEL, BLEZL, BGTZL
+  case 0x11: return (instruction >> 21 & 31) == 0x08 ? relative : 0;  //BC1
+  }
+  return 0;
+}
+
+//returns whether the instruction has a delay slot
+auto CPU::Recompiler::branches(u32 instruction) const -> bool {
+  switch(instruction >> 26) {
+  case 0x00: return (instruction & 0x3e) == 0x08;  //JR, JALR
+  case 0x01: return (instruction >> 16 & 0x0c) == 0x00;
+  case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07: return 1;
+  case 0x10: case 0x11: case 0x12: return (instruction >> 21 & 31) == 0x08;  //BC0, BC1, BC2
+  case 0x14: case 0x15: case 0x16: case 0x17: return 1;
+  }
+  return 0;
+}
+
+//likely branches skip their delay slot when not taken, ending the block right away
+auto CPU::Recompiler::branchLikely(u32 instruction) const -> bool {
+  switch(instruction >> 26) {
+  case 0x01: return (instruction >> 16 & 0x0e) == 0x02;  //BLTZL, BGEZL, BLTZALL, BGEZALL
+  case 0x14: case 0x15: case 0x16: case 0x17: return 1;  //BEQL, BNEL, BLEZL, BGTZL
+  case 0x11: return (instruction >> 21 & 31) == 0x08 && (instruction >> 17 & 1);  //BC1FL, BC1TL
+  }
+  return 0;
+}
+
 #define IpuBase        offsetof(IPU, r[16])
 #define IpuReg(r)      sreg(1), offsetof(IPU, r) - IpuBase
 #define PipelineReg(x) mem(sreg(0), offsetof(CPU, pipeline) + offsetof(Pipeline, x))
+#define RecompilerReg(x) mem(sreg(0), offsetof(CPU, recompiler) + offsetof(Recompiler, x))
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Winvalid-offsetof"
@@ -37,19 +184,48 @@ auto CPU::Recompiler::emit(u64 vaddr, u32 address, bool singleInstruction) -> Bl
     return nullptr;
 
   bool abort = false;
-  beginFunction(3);
+  beginFunction(3, cacheCapacity);
+  auto entry = sljit_emit_label(compiler);
+  allocate(address, singleInstruction);
+  pending = {};
+
+  //besides the end of the block, an instruction can end it early: the delay slot of a taken branch,
+  //a likely branch that is not taken, or any instruction that raises an exception.
+  //target is where the exit continues, or zero when that is not known until it runs.
+  //the rest is the state that the exit must store to memory before it leaves the block.
+  struct Exit {
+    sljit_jump* jump;
+    u32 clocks;
+    u64 target;
+    u32 dirty;
+    bool zero;
+    maybe<u64> pc;
+  };
+  vector<Exit> exits;
 
   Thread thread;
   bool hasBranched = 0;
+  bool delaySlot = 0;
+  u64 hasBranchedTo = 0;
   int numInsn = 0;
+  clocks = 0;
   constexpr u32 branchToSelf = 0x1000'ffff;  //beq 0,0,<pc>
   u32 jumpToSelf = 2 << 26 | vaddr >> 2 & 0x3ff'ffff;  //j <pc>
   while(true) {
     u32 instruction = bus.read<Word>(address, thread, "Ares Recompiler");
-    mov32(PipelineReg(nstate), imm(0));
-    mov64(reg(0), PipelineReg(nextpc));
-    mov64(PipelineReg(pc), reg(0));
-    add64(PipelineReg(nextpc), reg(0), imm(4));
+    //the pipeline is only unknown at the start of the block and in delay slots:
+    //otherwise the previous instruction did not branch, so this one follows it, and the branch state is clear.
+    bool known = numInsn && !delaySlot;
+    calls = 0;
+    if(known) {
+      pending.pc = vaddr + 4;
+    } else {
+      mov32(PipelineReg(nstate), imm(0));
+      mov64(reg(0), PipelineReg(nextpc));
+      mov64(PipelineReg(pc), reg(0));
+      add64(PipelineReg(nextpc), reg(0), imm(4));
+      pending.pc = nothing;
+    }
     if(callInstructionPrologue) {
       mov64(reg(1), imm(vaddr));
       mov32(reg(2), imm(instruction));
@@ -61,41 +237,186 @@ auto CPU::Recompiler::emit(u64 vaddr, u32 address, bool singleInstruction) -> Bl
         resetCompiler();
         return nullptr;  
       }
-      mov64(reg(1), imm(vaddr));
-      mov32(reg(2), imm(address));
-      call(&CPU::jitFetch);
+      emitFetch(vaddr, address);
     }
     numInsn++;
     bool branched = emitEXECUTE(instruction);
+    //clocks are charged once, as the block exits
     if(unlikely(instruction == branchToSelf || instruction == jumpToSelf)) {
       //accelerate idle loops
-      mov32(reg(1), imm(64 * 2));
-      call(&CPU::step);
+      clocks += 64 * 2;
     } else {
-      mov32(reg(1), imm(1 * 2));
-      call(&CPU::step);
+      clocks += 1 * 2;
     }
-    test32(PipelineReg(state), imm(Pipeline::EndBlock), set_z);
-    mov32(PipelineReg(state), PipelineReg(nstate));
-    mov64(mem(IpuReg(pc)), PipelineReg(pc));
+    //only called functions can end the block early
+    if(!known || calls) {
+      u64 target = 0;
+      if(hasBranched) target = hasBranchedTo;
+      else if(branchLikely(instruction)) target = vaddr + 8;
+      test32(PipelineReg(state), imm(Pipeline::EndBlock), set_z);
+      mov32(PipelineReg(state), PipelineReg(nstate));
+      exits.append({jump(flag_nz), clocks, target, cacheDirty(), pending.zero, pending.pc});
+    }
+    //the block continues with pipeline.pc, which follows this instruction even when it branched
+    pending.ipuPc = vaddr + 4;
+    u64 branchedTo = branchTarget(vaddr, instruction);
+    delaySlot = branches(instruction);
 
     vaddr += 4;
     address += 4;
     jumpToSelf += 4;
     if(hasBranched || (address & 0xfc) == 0 || singleInstruction) break;  //block boundary
     hasBranched = branched;
-    jumpEpilog(flag_nz);
+    hasBranchedTo = branchedTo;
   }
 
-  jumpEpilog();
+  //the last instruction did not end the block early: continue with the next one
+  exits.prepend({nullptr, clocks, vaddr, cacheDirty(), pending.zero, pending.pc});
 
   memory::jitprotect(false);
   auto block = (Block*)allocator.acquire(sizeof(Block));
-  block->code = endFunction();
+  auto links = (Link*)allocator.acquire(sizeof(Link) * exits.size());
+
+  //every exit charges the block's clocks to the budget, then returns to the dispatcher once it is spent.
+  //otherwise, exits with a known target take a patchable jump: it initially leads to a stub that
+  //returns to the dispatcher, which then links the jump to the block at the target.
+  //exits with an unknown target look up the block to continue at instead.
+  struct Patch {
+    Link* link;
+    u64 target;
+    sljit_jump* jump;
+    sljit_label* stub;
+  };
+  vector<Patch> patches;
+  for(auto& exit : exits) {
+    if(exit.jump) setLabel(exit.jump);
+    cacheStore(exit.dirty);
+    if(exit.zero) mov64(mem(IpuReg(r[0])), imm(0));
+    if(exit.pc) {
+      mov64(PipelineReg(pc), imm(*exit.pc));
+      mov64(PipelineReg(nextpc), imm(*exit.pc + 4));
+    }
+    mov64(mem(IpuReg(pc)), PipelineReg(pc));
+    sub64(RecompilerReg(budget), RecompilerReg(budget), imm(exit.clocks), set_sle);
+    jumpEpilog(flag_sle);
+    if(!exit.target) {
+      generic::call(&CPU::jitDispatch);
+      cmp64(reg(0), imm(0), set_z);
+      jumpEpilog(flag_z);
+      sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_R0, 0);
+      continue;
+    }
+    //the exit may have been taken by an exception instead, or the block entered from another mapping
+    cmp64(mem(IpuReg(pc)), imm(exit.target), set_z);
+    jumpEpilog(flag_nz);
+    auto link = &links[patches.size()];
+    auto jump = sljit_emit_jump(compiler, SLJIT_JUMP | SLJIT_REWRITABLE_JUMP);
+    auto stub = sljit_emit_label(compiler);
+    sljit_set_label(jump, stub);
+    mov64(RecompilerReg(unlinked), imm((sljit_sw)link));
+    jumpEpilog();
+    patches.append({link, exit.target, jump, stub});
+  }
+
+  block->code = generateFunction();
+  block->entry = (u8*)sljit_get_label_addr(entry);
+  block->links = nullptr;
+  block->address = address - numInsn * 4;
+  block->size = numInsn * 4;
+  block->sibling = nullptr;
+  for(auto& patch : patches) {
+    patch.link->target = patch.target;
+    patch.link->jump = (u8*)sljit_get_jump_addr(patch.jump);
+    patch.link->stub = (u8*)sljit_get_label_addr(patch.stub);
+    patch.link->next = nullptr;
+  }
+  resetCompiler();
 
 //print(hex(PC, 8L), " ", instructions, " ", size(), "\n");
   return block;
 }
+
+//only calls jitFetch() on an instruction cache miss
+auto CPU::Recompiler::emitFetch(u64 vaddr, u32 address) -> void {
+  auto& line = self.icache.line(vaddr);
+  cmp32(mem(sreg(0), (u8*)&line.tag - (u8*)&self), imm(address & ~0x0000'0fff), set_z);
+  auto miss = jump(flag_nz);
+  mov32_u8(reg(0), mem(sreg(0), (u8*)&line.valid - (u8*)&self));
+  cmp32(reg(0), imm(0), set_z);
+  auto hit = jump(flag_nz);
+  setLabel(miss);
+  mov64(reg(1), imm(vaddr));
+  mov32(reg(2), imm(address));
+  generic::call(&CPU::jitFetch);  //touches no guest state
+  setLabel(hit);
+}
+
+//binds the general purpose registers that the block uses most to host registers.
+//this scans the instructions the block will be compiled from, counting the register fields of each;
+//a register used only once gains nothing from being cached.
+auto CPU::Recompiler::allocate(u32 address, bool singleInstruction) -> void {
+  u32 uses[32] = {};
+  Thread thread;
+  bool branched = 0;
+  while(true) {
+    u32 instruction = bus.read<Word>(address, thread, "Ares Recompiler");
+    uses[instruction >> 21 & 31]++;
+    uses[instruction >> 16 & 31]++;
+    if(instruction >> 26 == 0x00) uses[instruction >> 11 & 31]++;
+    address += 4;
+    if(branched || (address & 0xfc) == 0 || singleInstruction) break;
+    branched = branches(instruction);
+  }
+  uses[0] = 0;
+  for(u32 count : range(cacheCapacity)) {
+    u32 best = 0;
+    for(u32 n : range(1, 32)) {
+      if(uses[n] > uses[best]) best = n;
+    }
+    if(uses[best] < 2) break;
+    cacheBind(mem(IpuReg(r[0]) + best * sizeof(r64)));
+    uses[best] = 0;
+  }
+}
+
+//r0 is cleared as the block next writes guest state back to memory
+auto CPU::Recompiler::emitZeroClear(u32 n) -> void {
+  if(n == 0) pending.zero = true;
+}
+
+//reads of r0 fold to zero, and the registers chosen by allocate() are kept in host registers
+auto CPU::Recompiler::readGPR(u32 n) -> op_base {
+  if(n == 0) return imm(0);
+  return cacheRead(mem(IpuReg(r[0]) + n * sizeof(r64)));
+}
+
+//as readGPR(), for instructions that only use the low word
+auto CPU::Recompiler::readGPR32(u32 n) -> op_base {
+  if(n == 0) return imm(0);
+  if(cacheFind(mem(IpuReg(r[0]) + n * sizeof(r64)))) return readGPR(n);
+  return mem(IpuReg(r[0].u32) + n * sizeof(r64));
+}
+
+auto CPU::Recompiler::writeGPR(u32 n) -> op_base {
+  if(n == 0) pending.zero = true;
+  return cacheWrite(mem(IpuReg(r[0]) + n * sizeof(r64)));
+}
+
+//stores the state that the block has kept out of memory
+auto CPU::Recompiler::sync() -> void {
+  cacheFlush();
+  if(pending.zero) mov64(mem(IpuReg(r[0])), imm(0));
+  if(pending.pc) {
+    mov64(PipelineReg(pc), imm(*pending.pc));
+    mov64(PipelineReg(nextpc), imm(*pending.pc + 4));
+  }
+  if(pending.ipuPc) mov64(mem(IpuReg(pc)), imm(*pending.ipuPc));
+  pending = {};
+}
+
+auto CPU::Recompiler::emitSpent() -> void {
+  mov32(RecompilerReg(spent), imm(clocks));
+}
 #pragma GCC diagnostic pop
 
 #define Sa  (instruction >>  6 & 31)
@@ -124,10 +445,6 @@ auto CPU::Recompiler::emit(u64 vaddr, u32 address, bool singleInstruction) -> Bl
 #define n16 u16(instruction)
 #define n26 u32(instruction & 0x03ff'ffff)
 
-auto CPU::Recompiler::emitZeroClear(u32 n) -> void {
-  if(n == 0) mov64(mem(IpuReg(r[0])), imm(0));
-}
-
 auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
   switch(instruction >> 26) {
 
@@ -202,53 +519,56 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
   //ADDIU Rt,Rs,i16
   case 0x09: {
     if(Rtn == 0) return 0;
-    add32(reg(0), mem(Rs32), imm(i16));
+    add32(reg(0), readGPR32(Rsn), imm(i16));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rt), reg(0));
+    mov64(writeGPR(Rtn), reg(0));
     return 0;
   }
 
   //SLTI Rt,Rs,i16
   case 0x0a: {
     if(Rtn == 0) return 0;
-    cmp64(mem(Rs), imm(i16), set_slt);
-    mov64_f(mem(Rt), flag_slt);
+    cmp64(readGPR(Rsn), imm(i16), set_slt);
+    mov64_f(writeGPR(Rtn), flag_slt);
     return 0;
   }
 
   //SLTIU Rt,Rs,i16
   case 0x0b: {
     if(Rtn == 0) return 0;
-    cmp64(mem(Rs), imm(i16), set_ult);
-    mov64_f(mem(Rt), flag_ult);
+    cmp64(readGPR(Rsn), imm(i16), set_ult);
+    mov64_f(writeGPR(Rtn), flag_ult);
     return 0;
   }
 
   //ANDI Rt,Rs,n16
   case 0x0c: {
     if(Rtn == 0) return 0;
-    and64(mem(Rt), mem(Rs), imm(n16));
+    auto rs = readGPR(Rsn);
+    and64(writeGPR(Rtn), rs, imm(n16));
     return 0;
   }
 
   //ORI Rt,Rs,n16
   case 0x0d: {
     if(Rtn == 0) return 0;
-    or64(mem(Rt), mem(Rs), imm(n16));
+    auto rs = readGPR(Rsn);
+    or64(writeGPR(Rtn), rs, imm(n16));
     return 0;
   }
 
   //XORI Rt,Rs,n16
   case 0x0e: {
     if(Rtn == 0) return 0;
-    xor64(mem(Rt), mem(Rs), imm(n16));
+    auto rs = readGPR(Rsn);
+    xor64(writeGPR(Rtn), rs, imm(n16));
     return 0;
   }
 
   //LUI Rt,n16
   case 0x0f: {
     if(Rtn == 0) return 0;
-    mov64(mem(Rt), imm(s32(n16 << 16)));
+    mov64(writeGPR(Rtn), imm(s32(n16 << 16)));
     return 0;
   }
 
@@ -647,9 +967,9 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //SLL Rd,Rt,Sa
   case 0x00: {
     if(Rdn == 0) return 0;
-    shl32(reg(0), mem(Rt32), imm(Sa));
+    shl32(reg(0), readGPR32(Rtn), imm(Sa));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
@@ -662,27 +982,27 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //SRL Rd,Rt,Sa
   case 0x02: {
     if(Rdn == 0) return 0;
-    lshr32(reg(0), mem(Rt32), imm(Sa));
+    lshr32(reg(0), readGPR32(Rtn), imm(Sa));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
   //SRA Rd,Rt,Sa
   case 0x03: {
     if(Rdn == 0) return 0;
-    ashr64(reg(0), mem(Rt), imm(Sa));
+    ashr64(reg(0), readGPR(Rtn), imm(Sa));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
   //SLLV Rd,Rt,Rs
   case 0x04: {
     if(Rdn == 0) return 0;
-    mshl32(reg(0), mem(Rt32), mem(Rs32));
+    mshl32(reg(0), readGPR32(Rtn), readGPR32(Rsn));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
@@ -695,19 +1015,19 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //SRLV Rd,Rt,RS
   case 0x06: {
     if(Rdn == 0) return 0;
-    mlshr32(reg(0), mem(Rt32), mem(Rs32));
+    mlshr32(reg(0), readGPR32(Rtn), readGPR32(Rsn));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
   //SRAV Rd,Rt,Rs
   case 0x07: {
     if(Rdn == 0) return 0;
-    and64(reg(1), mem(Rs), imm(31));
-    ashr64(reg(0), mem(Rt), reg(1));
+    and64(reg(1), readGPR(Rsn), imm(31));
+    ashr64(reg(0), readGPR(Rtn), reg(1));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
@@ -760,26 +1080,26 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //MFHI Rd
   case 0x10: {
     if(Rdn == 0) return 0;
-    mov64(mem(Rd), mem(Hi));
+    mov64(writeGPR(Rdn), mem(Hi));
     return 0;
   }
 
   //MTHI Rs
   case 0x11: {
-    mov64(mem(Hi), mem(Rs));
+    mov64(mem(Hi), readGPR(Rsn));
     return 0;
   }
 
   //MFLO Rd
   case 0x12: {
     if(Rdn == 0) return 0;
-    mov64(mem(Rd), mem(Lo));
+    mov64(writeGPR(Rdn), mem(Lo));
     return 0;
   }
 
   //MTLO Rs
   case 0x13: {
-    mov64(mem(Lo), mem(Rs));
+    mov64(mem(Lo), readGPR(Rsn));
     return 0;
   }
 
@@ -896,9 +1216,9 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //ADDU Rd,Rs,Rt
   case 0x21: {
     if(Rdn == 0) return 0;
-    add32(reg(0), mem(Rs32), mem(Rt32));
+    add32(reg(0), readGPR32(Rsn), readGPR32(Rtn));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
@@ -915,39 +1235,42 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //SUBU Rd,Rs,Rt
   case 0x23: {
     if(Rdn == 0) return 0;
-    sub32(reg(0), mem(Rs32), mem(Rt32));
+    sub32(reg(0), readGPR32(Rsn), readGPR32(Rtn));
     mov64_s32(reg(0), reg(0));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
   //AND Rd,Rs,Rt
   case 0x24: {
     if(Rdn == 0) return 0;
-    and64(mem(Rd), mem(Rs), mem(Rt));
+    auto rs = readGPR(Rsn), rt = readGPR(Rtn);
+    and64(writeGPR(Rdn), rs, rt);
     return 0;
   }
 
   //OR Rd,Rs,Rt
   case 0x25: {
     if(Rdn == 0) return 0;
-    or64(mem(Rd), mem(Rs), mem(Rt));
+    auto rs = readGPR(Rsn), rt = readGPR(Rtn);
+    or64(writeGPR(Rdn), rs, rt);
     return 0;
   }
 
   //XOR Rd,Rs,Rt
   case 0x26: {
     if(Rdn == 0) return 0;
-    xor64(mem(Rd), mem(Rs), mem(Rt));
+    auto rs = readGPR(Rsn), rt = readGPR(Rtn);
+    xor64(writeGPR(Rdn), rs, rt);
     return 0;
   }
 
   //NOR Rd,Rs,Rt
   case 0x27: {
     if(Rdn == 0) return 0;
-    or64(reg(0), mem(Rs), mem(Rt));
+    or64(reg(0), readGPR(Rsn), readGPR(Rtn));
     xor64(reg(0), reg(0), imm(-1));
-    mov64(mem(Rd), reg(0));
+    mov64(writeGPR(Rdn), reg(0));
     return 0;
   }
 
@@ -960,16 +1283,16 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
   //SLT Rd,Rs,Rt
   case 0x2a: {
     if(Rdn == 0) return 0;
-    cmp64(mem(Rs), mem(Rt), set_slt);
-    mov64_f(mem(Rd), flag_slt);
+    cmp64(readGPR(Rsn), readGPR(Rtn), set_slt);
+    mov64_f(writeGPR(Rdn), flag_slt);
     return 0;
   }
 
   //SLTU Rd,Rs,Rt
   case 0x2b: {
     if(Rdn == 0) return 0;
-    cmp64(mem(Rs), mem(Rt), set_ult);
-    mov64_f(mem(Rd), flag_ult);
+    cmp64(readGPR(Rsn), readGPR(Rtn), set_ult);
+    mov64_f(writeGPR(Rdn), flag_ult);
     return 0;
   }
 
@@ -177,6 +177,7 @@ auto DD::poll() -> void {
   line |= irq.mecha.line & irq.mecha.mask;
   line |= irq.bm.line & irq.bm.mask;
   cpu.scc.cause.interruptPending.bit(3) = line;
+  if constexpr(Accuracy::CPU::Recompiler) cpu.recompiler.stop();
 }
 
 }
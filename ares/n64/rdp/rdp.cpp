@@ -1,9 +1,11 @@
 #include <n64/n64.hpp>
+#include <thread>
 
 namespace ares::Nintendo64 {
 
 RDP rdp;
 #include "render.cpp"
+#include "software.cpp"
 #include "io.cpp"
 #include "debugger.cpp"
 #include "serialization.cpp"
@@ -14,6 +16,7 @@ auto RDP::load(Node::Object parent) -> void {
 }
 
 auto RDP::unload() -> void {
+  software.kill();
   debugger = {};
   node.reset();
 }
@@ -60,6 +63,7 @@ auto RDP::power(bool reset) -> void {
   fillRectangle_ = {};
   io.bist = {};
   io.test = {};
+  software.power();
 }
 
 }
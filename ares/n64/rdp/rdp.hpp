@@ -352,6 +352,189 @@ struct RDP : Thread, Memory::RCP<RDP> {
       n32 data;
     } test;
   } io{*this};
+
+//unserialized:
+  //software.cpp: draws on the CPU when the Vulkan renderer is disabled or unavailable.
+  //commands are decoded into queued primitives, which a pool of threads draws at Sync_Full.
+  struct Software {
+    RDP& self;
+    Software(RDP& self) : self(self) {}
+
+    static constexpr u32 Band = 8;         //rows per band; bands are dealt out to the threads in turn
+    static constexpr u32 Capacity = 4096;  //queued primitives before the queue is drawn early
+    static constexpr u32 Threads = 8;      //most threads to draw with, including the emulator thread
+
+    struct Color {
+      s32 r, g, b, a;
+    };
+
+    struct Tile {
+      u32 format;
+      u32 size;
+      u32 line;
+      u32 address;
+      u32 palette;
+      struct Axis {
+        u32 clamp;
+        u32 mirror;
+        u32 mask;
+        u32 shift;
+        u32 lo;  //10.2
+        u32 hi;  //10.2
+      } s, t;
+    };
+
+    struct TMEM {
+      u8 data[4_KiB];
+    };
+
+    //the render state a primitive is drawn with, decoded from the registers above.
+    struct State {
+      u32 cycleType;
+      u32 perspective;
+      u32 tlut;
+      u32 tlutType;
+      u32 bilinear;
+      u32 alphaCompare;
+      u32 ditherAlpha;
+      u32 colorDither;
+      u32 forceBlend;
+      u32 memory;  //the blender reads the color image
+      u32 zCompare;
+      u32 zUpdate;
+      u32 zSource;
+      u32 zMode;
+      u32 blend1a[2];
+      u32 blend1b[2];
+      u32 blend2a[2];
+      u32 blend2b[2];
+      struct Combiner {
+        u32 sba;
+        u32 sbb;
+        u32 mul;
+        u32 add;
+      } color[2], alpha[2];
+      Color fog;
+      Color blend;
+      Color primitive;
+      Color environment;
+      Color keyCenter;
+      Color keyScale;
+      s32 lodFraction;
+      s32 k4;
+      s32 k5;
+      struct Scissor {
+        s32 x0, y0;
+        s32 x1, y1;  //exclusive
+        u32 field;
+        u32 odd;
+      } scissor;
+      u32 primitiveZ;  //18-bit
+      u32 primitiveDeltaZ;
+      u32 fill;
+      struct Image {
+        u32 size;
+        u32 bytes;  //per pixel
+        u32 width;  //pixels
+        u32 address;
+      } image;
+      u32 depthAddress;
+      Tile tiles[8];
+      shared_pointer<TMEM> tmem;
+    };
+
+    struct Primitive {
+      enum class Type : u32 { Triangle, Rectangle } type;
+      shared_pointer<State> state;
+      u32 serial;   //seeds the noise input
+      u32 tile;
+      u32 texture;  //has texture coordinates
+      s32 y0, y1;   //rows drawn, after scissoring
+      //triangles:
+      u32 lmajor;
+      s32 yh, ym, yl;              //s11.2
+      s32 xh, xm, xl;              //s15.16
+      s32 dxh, dxm, dxl;           //s15.16
+      s32 c[8], dx[8], de[8];      //r, g, b, a, s, t, w, z; s15.16
+      u32 dz;                      //18-bit
+      //rectangles:
+      u32 flip;
+      s32 x0, x1;                  //pixels drawn, after scissoring
+      s32 xs, ys;                  //upper-left pixel
+      s32 s, t;                    //s10.5
+      s32 dsdx, dtdy;              //s5.10
+    };
+
+    struct Pixel {
+      Color shade;
+      Color texel0;
+      Color texel1;
+      Color combined;
+      u32 z;
+      u32 dz;
+      u32 noise;
+    };
+
+    //software.cpp
+    auto power() -> void;
+    auto kill() -> void;
+    auto setThreads(u32 count) -> void;
+    auto flush() -> void;
+    auto setTile() -> void;
+    auto setTileSize() -> void;
+    auto loadTile() -> void;
+    auto loadBlock() -> void;
+    auto loadTLUT() -> void;
+    auto triangle(bool shade, bool texture, bool depth) -> void;
+    auto rectangle(bool flip) -> void;
+    auto fillRectangle() -> void;
+
+    auto decode() -> shared_pointer<State>;
+    auto enqueue(Primitive& primitive) -> void;
+    auto modifyTMEM(u32 address, u32 length) -> u8*;
+    auto main(uintptr_t id) -> void;
+    template<typename F> auto rows(s32 y0, s32 y1, u32 id, const State& state, F&& draw) -> void;
+    auto draw(u32 id) -> void;
+    auto drawTriangle(const Primitive& primitive, u32 id) -> void;
+    auto drawRectangle(const Primitive& primitive, u32 id) -> void;
+    auto sample(const State& state, u32 tile, s32 s, s32 t) -> Color;
+    auto texel(const State& state, const Tile& tile, u32 s, u32 t) -> u32;
+    auto palette(const State& state, const Tile& tile, u32 value) -> u32;
+    auto unpack(const State& state, const Tile& tile, u32 value) -> Color;
+    auto combine(const State& state, u32 cycle, const Pixel& pixel) -> Color;
+    auto blend(const State& state, u32 cycle, bool enable, Color pixel, Color memory, s32 alpha, s32 shade) -> Color;
+    auto plot(const State& state, s32 x, s32 y, Pixel& pixel) -> void;
+    auto fill(const State& state, s32 x, s32 y) -> void;
+    static auto compress(u32 z) -> u32;
+    static auto shift(s32 coordinate, u32 shift) -> s32;
+    static auto wrap(s32 coordinate, const Tile::Axis& axis) -> u32;
+    static auto saturate(s32 value) -> s32;
+    static auto random(s32 x, s32 y, u32 seed) -> u32;
+    static auto decompress(u32 z) -> u32;
+    auto copy(const State& state, const Tile& tile, s32 x, s32 y, s32 s, s32 t) -> void;
+
+    bool dirty = true;
+    Tile tiles[8];
+    shared_pointer<TMEM> tmem;
+    shared_pointer<State> current;
+    vector<Primitive> queue;
+    u32 serial = 0;
+    struct Range {
+      u32 lo = ~0;
+      u32 hi = 0;
+    } written;  //RDRAM the queued primitives may write to
+
+    bool started = false;
+    bool stop = false;
+    u32 limit = 0;    //threads to draw with, or zero for one per hardware thread (up to Threads)
+    u32 threads = 1;
+    u64 batch = 0;
+    u32 pending = 0;
+    nall::thread workers[Threads - 1];
+    mutex lock;
+    condition_variable wake;
+    condition_variable idle;
+  } software{*this};
 };
 
 extern RDP rdp;
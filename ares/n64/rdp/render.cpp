@@ -560,42 +560,52 @@ auto RDP::invalidOperation() -> void {
 
 //0x08
 auto RDP::unshadedTriangle() -> void {
+  software.triangle(0, 0, 0);
 }
 
 //0x09
 auto RDP::unshadedZbufferTriangle() -> void {
+  software.triangle(0, 0, 1);
 }
 
 //0x0a
 auto RDP::textureTriangle() -> void {
+  software.triangle(0, 1, 0);
 }
 
 //0x0b
 auto RDP::textureZbufferTriangle() -> void {
+  software.triangle(0, 1, 1);
 }
 
 //0x0c
 auto RDP::shadedTriangle() -> void {
+  software.triangle(1, 0, 0);
 }
 
 //0x0d
 auto RDP::shadedZbufferTriangle() -> void {
+  software.triangle(1, 0, 1);
 }
 
 //0x0e
 auto RDP::shadedTextureTriangle() -> void {
+  software.triangle(1, 1, 0);
 }
 
 //0x0f
 auto RDP::shadedTextureZbufferTriangle() -> void {
+  software.triangle(1, 1, 1);
 }
 
 //0x24
 auto RDP::textureRectangle() -> void {
+  software.rectangle(0);
 }
 
 //0x25
 auto RDP::textureRectangleFlip() -> void {
+  software.rectangle(1);
 }
 
 //0x26
@@ -612,6 +622,7 @@ auto RDP::syncTile() -> void {
 
 //0x29
 auto RDP::syncFull() -> void {
+  software.flush();
   if(!command.crashed) {
     mi.raise(MI::IRQ::DP);
     command.bufferBusy = 0;
@@ -622,74 +633,92 @@ auto RDP::syncFull() -> void {
 
 //0x2a
 auto RDP::setKeyGB() -> void {
+  software.dirty = true;
 }
 
 //0x2b
 auto RDP::setKeyR() -> void {
+  software.dirty = true;
 }
 
 //0x2c
 auto RDP::setConvert() -> void {
+  software.dirty = true;
 }
 
 //0x2d
 auto RDP::setScissor() -> void {
+  software.dirty = true;
 }
 
 //0x2e
 auto RDP::setPrimitiveDepth() -> void {
+  software.dirty = true;
 }
 
 //0x2f
 auto RDP::setOtherModes() -> void {
+  software.dirty = true;
 }
 
 //0x30
 auto RDP::loadTLUT() -> void {
+  software.loadTLUT();
 }
 
 //0x32
 auto RDP::setTileSize() -> void {
+  software.setTileSize();
 }
 
 //0x33
 auto RDP::loadBlock() -> void {
+  software.loadBlock();
 }
 
 //0x34
 auto RDP::loadTile() -> void {
+  software.loadTile();
 }
 
 //0x35
 auto RDP::setTile() -> void {
+  software.setTile();
 }
 
 //0x36
 auto RDP::fillRectangle() -> void {
+  software.fillRectangle();
 }
 
 //0x37
 auto RDP::setFillColor() -> void {
+  software.dirty = true;
 }
 
 //0x38
 auto RDP::setFogColor() -> void {
+  software.dirty = true;
 }
 
 //0x39
 auto RDP::setBlendColor() -> void {
+  software.dirty = true;
 }
 
 //0x3a
 auto RDP::setPrimitiveColor() -> void {
+  software.dirty = true;
 }
 
 //0x3b
 auto RDP::setEnvironmentColor() -> void {
+  software.dirty = true;
 }
 
 //0x3c
 auto RDP::setCombineMode() -> void {
+  software.dirty = true;
 }
 
 //0x3d
@@ -698,8 +727,10 @@ auto RDP::setTextureImage() -> void {
 
 //0x3e
 auto RDP::setMaskImage() -> void {
+  software.dirty = true;
 }
 
 //0x3f
 auto RDP::setColorImage() -> void {
+  software.dirty = true;
 }
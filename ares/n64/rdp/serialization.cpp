@@ -1,4 +1,5 @@
 auto RDP::serialize(serializer& s) -> void {
+  software.flush();
   Thread::serialize(s);
 
   s(command.start);
@@ -0,0 +1,847 @@
+//a CPU implementation of the RDP: edge walker, texture unit, color combiner, blender and Z buffer.
+//every pixel is drawn with full coverage. antialiasing, mipmap level selection, detail and sharpen textures,
+//YUV textures and chroma keying are not emulated.
+
+//commands are not drawn as they arrive: each queues a primitive holding the render state it was issued with.
+//the queue is drawn at Sync_Full by up to Threads threads, each owning every Threads'th band of rows,
+//so that no two threads ever write the same pixel and the output does not depend on the number of threads.
+
+auto RDP::Software::power() -> void {
+  kill();
+  for(auto& tile : tiles) tile = {};
+  tmem = new TMEM{};
+  current.reset();
+  dirty = true;
+  queue.reset();
+  queue.reserve(Capacity);
+  serial = 0;
+  written = {};
+}
+
+auto RDP::Software::kill() -> void {
+  if(!started) return;
+  {
+    lock_guard<mutex> guard(lock);
+    stop = true;
+  }
+  wake.notify_all();
+  for(u32 id : range(threads - 1)) workers[id].join();
+  started = false;
+  stop = false;
+  batch = 0;
+}
+
+//the output is the same for any number of threads: this is only useful to check that it is.
+auto RDP::Software::setThreads(u32 count) -> void {
+  flush();
+  kill();
+  limit = count;
+}
+
+//draws all queued primitives, and returns once they are in RDRAM.
+auto RDP::Software::flush() -> void {
+  if(!queue) return;
+  if(!started) {
+    threads = max(1u, min(Threads, limit ? limit : std::thread::hardware_concurrency()));
+    for(u32 id : range(threads - 1)) workers[id] = nall::thread::create({&RDP::Software::main, this}, id + 1);
+    started = true;
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    pending = threads - 1;
+    batch++;
+  }
+  wake.notify_all();
+  draw(0);
+  {
+    unique_lock<mutex> guard(lock);
+    idle.wait(guard, [&] { return pending == 0; });
+  }
+  queue.resize(0);
+  written = {};
+}
+
+auto RDP::Software::main(uintptr_t id) -> void {
+  u64 drawn = 0;
+  while(true) {
+    {
+      unique_lock<mutex> guard(lock);
+      wake.wait(guard, [&] { return batch != drawn || stop; });
+      if(stop) return;
+      drawn = batch;
+    }
+    draw(id);
+    lock_guard<mutex> guard(lock);
+    if(--pending == 0) idle.notify_one();
+  }
+}
+
+auto RDP::Software::draw(u32 id) -> void {
+  for(auto& primitive : queue) {
+    if(primitive.type == Primitive::Type::Triangle) drawTriangle(primitive, id);
+    if(primitive.type == Primitive::Type::Rectangle) drawRectangle(primitive, id);
+  }
+}
+
+//visits the rows in [y0, y1) that belong to thread id, less those the field scissor removes.
+template<typename F> auto RDP::Software::rows(s32 y0, s32 y1, u32 id, const State& state, F&& draw) -> void {
+  s32 count = threads;
+  s32 band = y0 / (s32)Band;
+  band += ((s32)id - band % count + count) % count;
+  for(; band * (s32)Band < y1; band += count) {
+    s32 lo = max(y0, band * (s32)Band);
+    s32 hi = min(y1, band * (s32)Band + (s32)Band);
+    for(s32 y = lo; y < hi; y++) {
+      if(state.scissor.field && (u32)(y & 1) != state.scissor.odd) continue;
+      draw(y);
+    }
+  }
+}
+
+//returns the current render state, decoding it again if any register it depends on has changed.
+auto RDP::Software::decode() -> shared_pointer<State> {
+  if(current && !dirty) return current;
+  auto& other = self.other;
+  auto color = [](auto& source) -> Color {
+    return {source.red, source.green, source.blue, source.alpha};
+  };
+
+  shared_pointer<State> state = new State;
+  auto& s = *state;
+  s.cycleType    = other.cycleType;
+  s.perspective  = other.perspective;
+  s.tlut         = other.tlut;
+  s.tlutType     = other.tlutType;
+  s.bilinear     = other.sampleType;
+  s.alphaCompare = other.alphaCompare;
+  s.ditherAlpha  = other.ditherAlpha;
+  s.colorDither  = other.colorDitherMode;
+  s.forceBlend   = other.forceBlend;
+  s.zCompare     = other.zCompare;
+  s.zUpdate      = other.zUpdate;
+  s.zSource      = other.zSource;
+  s.zMode        = other.zMode;
+  s.memory       = 0;
+  for(u32 cycle : range(2)) {
+    s.blend1a[cycle] = other.blend1a[cycle];
+    s.blend1b[cycle] = other.blend1b[cycle];
+    s.blend2a[cycle] = other.blend2a[cycle];
+    s.blend2b[cycle] = other.blend2b[cycle];
+    s.memory |= s.blend1a[cycle] == 1 || s.blend2a[cycle] == 1 || s.blend2b[cycle] == 1;
+    s.color[cycle] = {self.combine.sba.color[cycle], self.combine.sbb.color[cycle], self.combine.mul.color[cycle], self.combine.add.color[cycle]};
+    s.alpha[cycle] = {self.combine.sba.alpha[cycle], self.combine.sbb.alpha[cycle], self.combine.mul.alpha[cycle], self.combine.add.alpha[cycle]};
+  }
+
+  s.fog         = color(self.fog);
+  s.blend       = color(self.blend);
+  s.primitive   = color(self.primitive);
+  s.environment = color(self.environment);
+  s.keyCenter   = {self.key.r.center, self.key.g.center, self.key.b.center, 0};
+  s.keyScale    = {self.key.r.scale,  self.key.g.scale,  self.key.b.scale,  0};
+  s.lodFraction = self.primitive.fraction;
+  s.k4 = (s32)sclip<9>(self.convert.k[4]);
+  s.k5 = (s32)sclip<9>(self.convert.k[5]);
+
+  s.scissor.x0    = self.scissor.x.hi >> 2;
+  s.scissor.y0    = self.scissor.y.hi >> 2;
+  s.scissor.x1    = self.scissor.x.lo >> 2;
+  s.scissor.y1    = self.scissor.y.lo >> 2;
+  s.scissor.field = self.scissor.field;
+  s.scissor.odd   = self.scissor.odd;
+
+  s.primitiveZ      = (self.primitiveDepth.z & 0x7fff) << 3;
+  s.primitiveDeltaZ = min(0x3ffffu, (u32)self.primitiveDepth.deltaZ << 3);
+  s.fill            = self.set.fill.color;
+  s.image.size      = self.set.color.size;
+  s.image.bytes     = s.image.size == 3 ? 4 : (u32)s.image.size;  //4-bit color images cannot be drawn to
+  s.image.width     = self.set.color.width + 1;
+  s.image.address   = self.set.color.dramAddress;
+  s.depthAddress    = self.set.mask.dramAddress;
+  for(u32 index : range(8)) s.tiles[index] = tiles[index];
+  s.tmem = tmem;
+
+  current = state;
+  dirty = false;
+  return current;
+}
+
+auto RDP::Software::enqueue(Primitive& primitive) -> void {
+  auto& state = *primitive.state;
+  primitive.y0 = max(primitive.y0, state.scissor.y0);
+  primitive.y1 = min(primitive.y1, state.scissor.y1);
+  if(primitive.y0 >= primitive.y1 || !state.image.bytes) return;
+  primitive.serial = serial++;
+
+  u32 pitch = state.image.width * state.image.bytes;
+  written.lo = min(written.lo, state.image.address + primitive.y0 * pitch);
+  written.hi = max(written.hi, state.image.address + primitive.y1 * pitch);
+  if(state.zUpdate && state.cycleType < 2) {
+    pitch = state.image.width * 2;
+    written.lo = min(written.lo, state.depthAddress + primitive.y0 * pitch);
+    written.hi = max(written.hi, state.depthAddress + primitive.y1 * pitch);
+  }
+
+  queue.append(primitive);
+  if(queue.size() >= Capacity) flush();
+}
+
+//loads from RDRAM into TMEM: queued primitives that may have drawn to the source are drawn first,
+//and TMEM is copied if any queued primitive still needs its previous contents.
+auto RDP::Software::modifyTMEM(u32 address, u32 length) -> u8* {
+  if(address < written.hi && address + length > written.lo) flush();
+  if(!queue) current.reset();
+  if(tmem.references() > 1) tmem = new TMEM{*tmem};
+  dirty = true;
+  return tmem->data;
+}
+
+auto RDP::Software::setTile() -> void {
+  auto& source = self.tile;
+  auto& tile = tiles[source.index];
+  tile.format   = source.format;
+  tile.size     = source.size;
+  tile.line     = source.line;
+  tile.address  = source.address;
+  tile.palette  = source.palette;
+  tile.s.clamp  = source.s.clamp;
+  tile.s.mirror = source.s.mirror;
+  tile.s.mask   = source.s.mask;
+  tile.s.shift  = source.s.shift;
+  tile.t.clamp  = source.t.clamp;
+  tile.t.mirror = source.t.mirror;
+  tile.t.mask   = source.t.mask;
+  tile.t.shift  = source.t.shift;
+  dirty = true;
+}
+
+auto RDP::Software::setTileSize() -> void {
+  auto& source = self.tileSize;
+  auto& tile = tiles[source.index];
+  tile.s.lo = source.s.lo;
+  tile.t.lo = source.t.lo;
+  tile.s.hi = source.s.hi;
+  tile.t.hi = source.t.hi;
+  dirty = true;
+}
+
+auto RDP::Software::loadTile() -> void {
+  auto& source = self.load_.tile;
+  auto& image = self.set.texture;
+  auto& tile = tiles[source.index];
+  tile.s.lo = source.s.lo;
+  tile.t.lo = source.t.lo;
+  tile.s.hi = source.s.hi;
+  tile.t.hi = source.t.hi;
+  u32 s0 = source.s.lo >> 2, s1 = source.s.hi >> 2;
+  u32 t0 = source.t.lo >> 2, t1 = source.t.hi >> 2;
+  if(s1 < s0 || t1 < t0) return;
+
+  u32 bits = 4 << image.size;
+  u32 width = image.width + 1;
+  u32 address = image.dramAddress + t0 * width * bits / 8;
+  auto data = modifyTMEM(address, (t1 + 1 - t0) * width * bits / 8);
+  for(u32 t : range(t0, t1 + 1)) {
+    u32 row = t - t0;
+    u32 swap = (row & 1) << 2;  //odd rows have their 32-bit words swapped
+    u32 source = image.dramAddress + (t * width + s0) * bits / 8;
+    u32 target = tile.address * 8 + row * tile.line * 8;
+    if(image.size == 3) {
+      //32-bit texels are split: red and green in the lower half of TMEM, blue and alpha in the upper half
+      for(u32 s : range(s1 + 1 - s0)) {
+        u32 texel = rdram.ram.read<Word>(source + s * 4, "RDP");
+        u32 offset = (target + s * 2 ^ swap) & 0x7fe;
+        data[offset + 0x000] = texel >> 24;
+        data[offset + 0x001] = texel >> 16;
+        data[offset + 0x800] = texel >>  8;
+        data[offset + 0x801] = texel >>  0;
+      }
+    } else {
+      for(u32 n : range(((s1 + 1 - s0) * bits + 7) / 8)) {
+        data[(target + n ^ swap) & 0xfff] = rdram.ram.read<Byte>(source + n, "RDP");
+      }
+    }
+  }
+}
+
+auto RDP::Software::loadBlock() -> void {
+  auto& source = self.load_.block;
+  auto& image = self.set.texture;
+  auto& tile = tiles[source.index];
+  tile.s.lo = source.s.lo;
+  tile.t.lo = source.t.lo;
+  tile.s.hi = source.s.hi;
+  tile.t.hi = source.t.hi;
+  if(source.s.hi < source.s.lo) return;
+
+  //s.hi is the index of the last texel; t.hi is the 1.11 row increment applied after each 64-bit word
+  u32 count = source.s.hi - source.s.lo + 1;
+  u32 dxt = source.t.hi;
+  u32 bits = 4 << image.size;
+  u32 address = image.dramAddress + (source.t.lo * (image.width + 1) + source.s.lo) * bits / 8;
+  u32 target = tile.address * 8;
+  auto swap = [&](u32 word) -> u32 { return (word * dxt >> 11 & 1) << 2; };
+  auto data = modifyTMEM(address, count * bits / 8);
+  if(image.size == 3) {
+    for(u32 n : range(count)) {
+      u32 texel = rdram.ram.read<Word>(address + n * 4, "RDP");
+      u32 offset = (target + n * 2 ^ swap(n / 4)) & 0x7fe;
+      data[offset + 0x000] = texel >> 24;
+      data[offset + 0x001] = texel >> 16;
+      data[offset + 0x800] = texel >>  8;
+      data[offset + 0x801] = texel >>  0;
+    }
+  } else {
+    for(u32 n : range((count * bits + 7) / 8)) {
+      data[(target + n ^ swap(n / 8)) & 0xfff] = rdram.ram.read<Byte>(address + n, "RDP");
+    }
+  }
+}
+
+auto RDP::Software::loadTLUT() -> void {
+  auto& source = self.tlut;
+  auto& image = self.set.texture;
+  auto& tile = tiles[source.index];
+  u32 s0 = source.s.lo >> 2, s1 = source.s.hi >> 2;
+  if(s1 < s0) return;
+
+  u32 count = s1 + 1 - s0;
+  u32 address = image.dramAddress + ((source.t.lo >> 2) * (image.width + 1) + s0) * 2;
+  u32 target = tile.address * 8;
+  auto data = modifyTMEM(address, count * 2);
+  for(u32 n : range(count)) {
+    u16 entry = rdram.ram.read<Half>(address + n * 2, "RDP");
+    //each entry is stored four times, once for each texel a bilinear filter reads at once
+    for(u32 copy : range(4)) {
+      u32 offset = (target + n * 8 + copy * 2) & 0xffe;
+      data[offset + 0] = entry >> 8;
+      data[offset + 1] = entry >> 0;
+    }
+  }
+}
+
+auto RDP::Software::triangle(bool shade, bool texture, bool depth) -> void {
+  auto fixed = [](const Point& point) -> s32 {
+    return (s32)((u32)point.i << 16 | (u32)point.f);
+  };
+  auto& edge = self.edge;
+
+  Primitive primitive{};
+  primitive.type    = Primitive::Type::Triangle;
+  primitive.state   = decode();
+  primitive.tile    = edge.tile;
+  primitive.texture = texture;
+  primitive.lmajor  = edge.lmajor;
+  primitive.yh  = (s32)sclip<14>(edge.y.hi);
+  primitive.ym  = (s32)sclip<14>(edge.y.md);
+  primitive.yl  = (s32)sclip<14>(edge.y.lo);
+  primitive.xh  = fixed(edge.x.hi.c);
+  primitive.xm  = fixed(edge.x.md.c);
+  primitive.xl  = fixed(edge.x.lo.c);
+  primitive.dxh = fixed(edge.x.hi.s);
+  primitive.dxm = fixed(edge.x.md.s);
+  primitive.dxl = fixed(edge.x.lo.s);
+  if(shade) {
+    u32 n = 0;
+    for(auto channel : {&self.shade.r, &self.shade.g, &self.shade.b, &self.shade.a}) {
+      primitive.c[n]  = fixed(channel->c);
+      primitive.dx[n] = fixed(channel->x);
+      primitive.de[n] = fixed(channel->e);
+      n++;
+    }
+  }
+  if(texture) {
+    u32 n = 4;
+    for(auto coordinate : {&self.texture.s, &self.texture.t, &self.texture.w}) {
+      primitive.c[n]  = fixed(coordinate->c);
+      primitive.dx[n] = fixed(coordinate->x);
+      primitive.de[n] = fixed(coordinate->e);
+      n++;
+    }
+  }
+  if(depth) {
+    primitive.c[7]  = fixed(self.zbuffer.d);
+    primitive.dx[7] = fixed(self.zbuffer.x);
+    primitive.de[7] = fixed(self.zbuffer.e);
+    u64 slope = abs((s64)primitive.dx[7]) + abs((s64)fixed(self.zbuffer.y));
+    primitive.dz = min(0x3ffffull, slope >> 13);
+  }
+  primitive.y0 = primitive.yh >> 2;
+  primitive.y1 = primitive.yl + 3 >> 2;
+  enqueue(primitive);
+}
+
+auto RDP::Software::rectangle(bool flip) -> void {
+  auto& source = self.rectangle;
+  Primitive primitive{};
+  primitive.type    = Primitive::Type::Rectangle;
+  primitive.state   = decode();
+  primitive.tile    = source.tile;
+  primitive.texture = 1;
+  primitive.flip    = flip;
+  primitive.s       = (s16)source.s.i;
+  primitive.t       = (s16)source.t.i;
+  primitive.dsdx    = (s16)source.s.f;
+  primitive.dtdy    = (s16)source.t.f;
+
+  //fill and copy modes include the lower-right edge
+  auto& state = *primitive.state;
+  s32 inclusive = state.cycleType >= 2;
+  primitive.xs = source.x.hi >> 2;
+  primitive.ys = source.y.hi >> 2;
+  primitive.x0 = max(primitive.xs, state.scissor.x0);
+  primitive.x1 = min((s32)(source.x.lo >> 2) + inclusive, state.scissor.x1);
+  primitive.y0 = primitive.ys;
+  primitive.y1 = (s32)(source.y.lo >> 2) + inclusive;
+  if(primitive.x0 >= primitive.x1) return;
+  enqueue(primitive);
+}
+
+auto RDP::Software::fillRectangle() -> void {
+  auto& source = self.fillRectangle_;
+  Primitive primitive{};
+  primitive.type  = Primitive::Type::Rectangle;
+  primitive.state = decode();
+
+  auto& state = *primitive.state;
+  s32 inclusive = state.cycleType >= 2;
+  primitive.xs = source.x.hi >> 2;
+  primitive.ys = source.y.hi >> 2;
+  primitive.x0 = max(primitive.xs, state.scissor.x0);
+  primitive.x1 = min((s32)(source.x.lo >> 2) + inclusive, state.scissor.x1);
+  primitive.y0 = primitive.ys;
+  primitive.y1 = (s32)(source.y.lo >> 2) + inclusive;
+  if(primitive.x0 >= primitive.x1) return;
+  enqueue(primitive);
+}
+
+auto RDP::Software::drawTriangle(const Primitive& p, u32 id) -> void {
+  auto& state = *p.state;
+  rows(p.y0, p.y1, id, state, [&](s32 y) {
+    //the span covers every pixel whose center lies inside the triangle on any of the row's four subscanlines
+    s64 x0 = s64(1) << 40, x1 = -x0;
+    for(s32 k = y * 4; k < y * 4 + 4; k++) {
+      if(k < p.yh || k >= p.yl) continue;
+      s64 major = p.xh + ((s64)p.dxh * (k - (p.yh & ~3)) >> 2);
+      s64 minor = k < p.ym ? p.xm + ((s64)p.dxm * (k - (p.yh & ~3)) >> 2) : p.xl + ((s64)p.dxl * (k - p.ym) >> 2);
+      s64 left  = p.lmajor ? major : minor;
+      s64 right = p.lmajor ? minor : major;
+      if(left >= right) continue;
+      x0 = min(x0, left  + 0x7fff >> 16);
+      x1 = max(x1, right + 0x7fff >> 16);
+    }
+    x0 = max(x0, (s64)state.scissor.x0);
+    x1 = min(x1, (s64)state.scissor.x1);
+    if(x0 >= x1) return;
+
+    if(state.cycleType == 3) {
+      for(s32 x = x0; x < x1; x++) fill(state, x, y);
+      return;
+    }
+
+    //attributes step along the major edge once per row, then across the row from the major edge
+    s32 lines = y - (p.yh >> 2);
+    s64 major = p.xh + (s64)p.dxh * lines;
+    u32 value[8];
+    for(u32 n : range(8)) value[n] = p.c[n] + (s64)p.de[n] * lines + ((s64)p.dx[n] * ((x0 << 16) - major) >> 16);
+
+    for(s32 x = x0; x < x1; x++) {
+      Pixel pixel{};
+      pixel.shade = {
+        saturate((s32)value[0] >> 16), saturate((s32)value[1] >> 16),
+        saturate((s32)value[2] >> 16), saturate((s32)value[3] >> 16),
+      };
+      if(p.texture) {
+        s32 s = (s32)value[4] >> 16;
+        s32 t = (s32)value[5] >> 16;
+        if(state.perspective) {
+          s64 w = max((s64)1, (s64)(s32)value[6]);
+          s = max((s64)-0x10000, min((s64)0xffff, ((s64)(s32)value[4] << 15) / w));
+          t = max((s64)-0x10000, min((s64)0xffff, ((s64)(s32)value[5] << 15) / w));
+        }
+        pixel.texel0 = sample(state, p.tile, s, t);
+        if(state.cycleType == 1) pixel.texel1 = sample(state, p.tile + 1, s, t);
+      }
+      if(state.zSource) {
+        pixel.z  = state.primitiveZ;
+        pixel.dz = state.primitiveDeltaZ;
+      } else {
+        pixel.z  = max(0, min(0x3ffff, (s32)value[7] >> 13));
+        pixel.dz = p.dz;
+      }
+      pixel.noise = random(x, y, p.serial);
+      plot(state, x, y, pixel);
+      for(u32 n : range(8)) value[n] += p.dx[n];
+    }
+  });
+}
+
+auto RDP::Software::drawRectangle(const Primitive& p, u32 id) -> void {
+  auto& state = *p.state;
+  auto& tile = state.tiles[p.tile];
+  rows(p.y0, p.y1, id, state, [&](s32 y) {
+    for(s32 x = p.x0; x < p.x1; x++) {
+      if(state.cycleType == 3) {
+        fill(state, x, y);
+        continue;
+      }
+
+      s32 u = x - p.xs, v = y - p.ys;
+      if(p.flip) swap(u, v);
+      if(state.cycleType == 2) {
+        //copy mode steps four texels per clock, so DsDx is four times the step per pixel
+        s32 s = shift(p.s + (p.dsdx * u >> 7), tile.s.shift) - (s32)(tile.s.lo << 3);
+        s32 t = shift(p.t + (p.dtdy * v >> 5), tile.t.shift) - (s32)(tile.t.lo << 3);
+        copy(state, tile, x, y, wrap(s >> 5, tile.s), wrap(t >> 5, tile.t));
+        continue;
+      }
+
+      Pixel pixel{};
+      if(p.texture) {
+        s32 s = p.s + (p.dsdx * u >> 5);
+        s32 t = p.t + (p.dtdy * v >> 5);
+        pixel.texel0 = sample(state, p.tile, s, t);
+        if(state.cycleType == 1) pixel.texel1 = sample(state, p.tile + 1, s, t);
+      }
+      pixel.z = state.primitiveZ;
+      pixel.dz = state.primitiveDeltaZ;
+      pixel.noise = random(x, y, p.serial);
+      plot(state, x, y, pixel);
+    }
+  });
+}
+
+//s and t are s10.5 texel coordinates.
+auto RDP::Software::sample(const State& state, u32 index, s32 s, s32 t) -> Color {
+  auto& tile = state.tiles[index & 7];
+  s = shift(s, tile.s.shift) - (s32)(tile.s.lo << 3);
+  t = shift(t, tile.t.shift) - (s32)(tile.t.lo << 3);
+  if(!state.bilinear) return unpack(state, tile, texel(state, tile, wrap(s >> 5, tile.s), wrap(t >> 5, tile.t)));
+
+  //the RDP filters between three texels: the nearest corner and its two neighbors
+  s32 fs = s & 31, ft = t & 31;
+  u32 s0 = wrap(s >> 5, tile.s), s1 = wrap((s >> 5) + 1, tile.s);
+  u32 t0 = wrap(t >> 5, tile.t), t1 = wrap((t >> 5) + 1, tile.t);
+  auto lerp = [](s32 base, s32 a, s32 b, s32 fa, s32 fb) -> s32 {
+    return base + ((a - base) * fa + (b - base) * fb + 16 >> 5);
+  };
+  auto c1 = unpack(state, tile, texel(state, tile, s1, t0));
+  auto c2 = unpack(state, tile, texel(state, tile, s0, t1));
+  if(fs + ft < 32) {
+    auto c0 = unpack(state, tile, texel(state, tile, s0, t0));
+    return {lerp(c0.r, c1.r, c2.r, fs, ft), lerp(c0.g, c1.g, c2.g, fs, ft), lerp(c0.b, c1.b, c2.b, fs, ft), lerp(c0.a, c1.a, c2.a, fs, ft)};
+  }
+  auto c3 = unpack(state, tile, texel(state, tile, s1, t1));
+  fs = 32 - fs, ft = 32 - ft;
+  return {lerp(c3.r, c2.r, c1.r, fs, ft), lerp(c3.g, c2.g, c1.g, fs, ft), lerp(c3.b, c2.b, c1.b, fs, ft), lerp(c3.a, c2.a, c1.a, fs, ft)};
+}
+
+//returns the texel at (s, t) of the tile as stored in TMEM.
+auto RDP::Software::texel(const State& state, const Tile& tile, u32 s, u32 t) -> u32 {
+  auto data = state.tmem->data;
+  auto half = [&](u32 address) -> u32 { return data[address] << 8 | data[address + 1]; };
+  u32 base = tile.address * 8 + t * tile.line * 8;
+  u32 swap = (t & 1) << 2;
+  u32 mask = state.tlut ? 0x7ff : 0xfff;  //the palette occupies the upper half of TMEM
+  switch(tile.size) {
+  case 0: {
+    u8 byte = data[(base + (s >> 1) ^ swap) & mask];
+    return s & 1 ? byte & 15 : byte >> 4;
+  }
+  case 1: return data[(base + s ^ swap) & mask];
+  case 2: return half((base + s * 2 ^ swap) & mask & ~1);
+  }
+  u32 address = (base + s * 2 ^ swap) & 0x7fe;
+  return half(address) << 16 | half(address | 0x800);
+}
+
+//returns the palette entry for a 4-bit or 8-bit texel.
+auto RDP::Software::palette(const State& state, const Tile& tile, u32 value) -> u32 {
+  u32 index = tile.size == 0 ? tile.palette << 4 | value : value;
+  auto data = state.tmem->data + 0x800 + index * 8;
+  return data[0] << 8 | data[1];
+}
+
+auto RDP::Software::unpack(const State& state, const Tile& tile, u32 value) -> Color {
+  auto rgba16 = [](u32 value) -> Color {
+    s32 r = value >> 11 & 31, g = value >> 6 & 31, b = value >> 1 & 31;
+    return {r << 3 | r >> 2, g << 3 | g >> 2, b << 3 | b >> 2, value & 1 ? 255 : 0};
+  };
+  auto ia16 = [](u32 value) -> Color {
+    s32 i = value >> 8 & 255;
+    return {i, i, i, s32(value & 255)};
+  };
+  auto i8 = [](u32 value) -> Color {
+    s32 i = value & 255;
+    return {i, i, i, i};
+  };
+
+  if(state.tlut && tile.size <= 1) {
+    u32 entry = palette(state, tile, value);
+    return state.tlutType ? ia16(entry) : rgba16(entry);
+  }
+  switch(tile.format << 2 | tile.size) {
+  case 0 << 2 | 2: return rgba16(value);
+  case 2 << 2 | 0: return i8(tile.palette << 4 | value);
+  case 3 << 2 | 0: {
+    s32 i = value >> 1;
+    i = i << 5 | i << 2 | i >> 1;
+    return {i, i, i, value & 1 ? 255 : 0};
+  }
+  case 3 << 2 | 1: {
+    s32 i = (value >> 4) * 0x11;
+    return {i, i, i, s32(value & 15) * 0x11};
+  }
+  }
+  if(tile.size == 0) return i8(value * 0x11);
+  if(tile.size == 1) return i8(value);
+  if(tile.size == 2) return ia16(value);
+  return {s32(value >> 24), s32(value >> 16 & 255), s32(value >> 8 & 255), s32(value & 255)};
+}
+
+//evaluates (a - b) * c + d for one cycle of the color combiner.
+auto RDP::Software::combine(const State& state, u32 cycle, const Pixel& pixel) -> Color {
+  auto& color = state.color[cycle];
+  auto& alpha = state.alpha[cycle];
+  auto splat = [](s32 value) -> Color { return {value, value, value, value}; };
+
+  auto common = [&](u32 select) -> Color {
+    switch(select) {
+    case 0: return pixel.combined;
+    case 1: return pixel.texel0;
+    case 2: return pixel.texel1;
+    case 3: return state.primitive;
+    case 4: return pixel.shade;
+    case 5: return state.environment;
+    }
+    return splat(0);
+  };
+
+  Color a = common(color.sba);
+  if(color.sba == 6) a = splat(256);
+  if(color.sba == 7) a = splat((pixel.noise & 7) << 6 | 0x20);
+
+  Color b = common(color.sbb);
+  if(color.sbb == 6) b = state.keyCenter;
+  if(color.sbb == 7) b = splat(state.k4);
+
+  Color c = common(color.mul);
+  switch(color.mul) {
+  case  6: c = state.keyScale; break;
+  case  7: c = splat(pixel.combined.a); break;
+  case  8: c = splat(pixel.texel0.a); break;
+  case  9: c = splat(pixel.texel1.a); break;
+  case 10: c = splat(state.primitive.a); break;
+  case 11: c = splat(pixel.shade.a); break;
+  case 12: c = splat(state.environment.a); break;
+  case 13: c = splat(0); break;  //LOD fraction: only the base level is sampled
+  case 14: c = splat(state.lodFraction); break;
+  case 15: c = splat(state.k5); break;
+  }
+
+  Color d = common(color.add);
+  if(color.add == 6) d = splat(256);
+
+  auto alphaInput = [&](u32 select) -> s32 {
+    if(select == 6) return 256;
+    return common(select).a;
+  };
+  s32 alphaC = alpha.mul == 0 ? 0 : alpha.mul == 6 ? state.lodFraction : common(alpha.mul).a;
+
+  auto equation = [](s32 a, s32 b, s32 c, s32 d) -> s32 {
+    return saturate((a - b) * c + (d << 8) + 0x80 >> 8);
+  };
+  return {
+    equation(a.r, b.r, c.r, d.r),
+    equation(a.g, b.g, c.g, d.g),
+    equation(a.b, b.b, c.b, d.b),
+    equation(alphaInput(alpha.sba), alphaInput(alpha.sbb), alphaC, alphaInput(alpha.add)),
+  };
+}
+
+//evaluates (p * a + m * b) for one cycle of the blender, or passes p through when blending is disabled.
+auto RDP::Software::blend(const State& state, u32 cycle, bool enable, Color pixel, Color memory, s32 alpha, s32 shade) -> Color {
+  auto input = [&](u32 select) -> Color {
+    switch(select) {
+    case 0: return pixel;
+    case 1: return memory;
+    case 2: return state.blend;
+    }
+    return state.fog;
+  };
+
+  Color p = input(state.blend1a[cycle]);
+  if(!enable) return p;
+  Color m = input(state.blend2a[cycle]);
+  s32 a = 0, b = 0;
+  switch(state.blend1b[cycle]) {
+  case 0: a = alpha; break;
+  case 1: a = state.fog.a; break;
+  case 2: a = shade; break;
+  }
+  switch(state.blend2b[cycle]) {
+  case 0: b = 255 - a; break;
+  case 1: b = memory.a; break;
+  case 2: b = 255; break;
+  }
+  a = a >> 3;
+  b = (b >> 3) + 1;
+  return {
+    min(255, p.r * a + m.r * b >> 5),
+    min(255, p.g * a + m.g * b >> 5),
+    min(255, p.b * a + m.b * b >> 5),
+    pixel.a,
+  };
+}
+
+//runs a pixel through the Z test, combiner and blender (one or two cycle mode), and writes it.
+auto RDP::Software::plot(const State& state, s32 x, s32 y, Pixel& pixel) -> void {
+  u32 offset = y * state.image.width + x;
+  u32 depthAddress = state.depthAddress + offset * 2;
+  if(state.zCompare) {
+    u32 depth = decompress(rdram.ram.read<Half>(depthAddress, nullptr));
+    if(state.zMode == 3) {
+      //decals pass within the slope of the new surface, or the precision of the stored depth
+      u32 exponent = 0;
+      while(exponent < 7 && depth >> (17 - exponent) & 1) exponent++;
+      s32 tolerance = max(pixel.dz, 1u << (exponent < 6 ? 6 - exponent : 0));
+      if(abs((s32)pixel.z - (s32)depth) > tolerance) return;
+    } else {
+      if(pixel.z > depth) return;
+    }
+  }
+
+  Color color;
+  if(state.cycleType == 1) {
+    pixel.combined = combine(state, 0, pixel);
+    color = combine(state, 1, pixel);
+  } else {
+    //one cycle mode uses the second cycle's combiner settings
+    color = combine(state, 1, pixel);
+  }
+  if(state.alphaCompare) {
+    s32 threshold = state.ditherAlpha ? pixel.noise >> 8 & 255 : state.blend.a;
+    if(color.a <= threshold) return;
+  }
+
+  u32 address = state.image.address + offset * state.image.bytes;
+  Color memory{};
+  if(state.memory) {
+    if(state.image.size == 2) {
+      u32 data = rdram.ram.read<Half>(address, nullptr);
+      memory = {s32(data >> 8 & 0xf8), s32(data >> 3 & 0xf8), s32(data << 2 & 0xf8), data & 1 ? 0xe0 : 0};
+    }
+    if(state.image.size == 3) {
+      u32 data = rdram.ram.read<Word>(address, nullptr);
+      memory = {s32(data >> 24), s32(data >> 16 & 255), s32(data >> 8 & 255), s32(data & 0xe0)};
+    }
+  }
+  if(state.cycleType == 1) {
+    //the first cycle always blends; its result is the second cycle's pixel input
+    Color first = blend(state, 0, true, color, memory, color.a, pixel.shade.a);
+    color = blend(state, 1, state.forceBlend, first, memory, color.a, pixel.shade.a);
+  } else {
+    color = blend(state, 0, state.forceBlend, color, memory, color.a, pixel.shade.a);
+  }
+
+  switch(state.image.size) {
+  case 1:
+    rdram.ram.write<Byte>(address, color.r, nullptr);
+    break;
+  case 2: {
+    static constexpr u8 magic[16] = {0, 6, 1, 7, 4, 2, 5, 3, 3, 5, 2, 4, 7, 1, 6, 0};
+    static constexpr u8 bayer[16] = {0, 4, 1, 5, 4, 0, 5, 1, 3, 7, 2, 6, 7, 3, 6, 2};
+    if(state.colorDither != 3) {
+      s32 threshold = pixel.noise & 7;
+      if(state.colorDither == 0) threshold = magic[(y & 3) << 2 | (x & 3)];
+      if(state.colorDither == 1) threshold = bayer[(y & 3) << 2 | (x & 3)];
+      if((color.r & 7) > threshold) color.r = min(255, color.r + 8);
+      if((color.g & 7) > threshold) color.g = min(255, color.g + 8);
+      if((color.b & 7) > threshold) color.b = min(255, color.b + 8);
+    }
+    rdram.ram.write<Half>(address, (color.r >> 3) << 11 | (color.g >> 3) << 6 | (color.b >> 3) << 1 | 1, nullptr);
+  } break;
+  case 3:
+    rdram.ram.write<Word>(address, (u32)color.r << 24 | color.g << 16 | color.b << 8 | 0xe0, nullptr);
+    break;
+  }
+  if(state.zUpdate) rdram.ram.write<Half>(depthAddress, compress(pixel.z), nullptr);
+}
+
+//fill mode writes the fill color register; 8-bit and 16-bit pixels take the part of it matching their address.
+auto RDP::Software::fill(const State& state, s32 x, s32 y) -> void {
+  u32 address = state.image.address + (y * state.image.width + x) * state.image.bytes;
+  switch(state.image.size) {
+  case 1: rdram.ram.write<Byte>(address, state.fill >> 24 - (address & 3) * 8, nullptr); break;
+  case 2: rdram.ram.write<Half>(address, address & 2 ? state.fill : state.fill >> 16, nullptr); break;
+  case 3: rdram.ram.write<Word>(address, state.fill, nullptr); break;
+  }
+}
+
+//copy mode writes texels as they are stored, through the palette if enabled.
+auto RDP::Software::copy(const State& state, const Tile& tile, s32 x, s32 y, s32 s, s32 t) -> void {
+  u32 address = state.image.address + (y * state.image.width + x) * state.image.bytes;
+  u32 value = texel(state, tile, s, t);
+  if(state.tlut && tile.size <= 1) value = palette(state, tile, value);
+  switch(state.image.size) {
+  case 1:
+    rdram.ram.write<Byte>(address, value, nullptr);
+    break;
+  case 2:
+    if(tile.size == 3) value = (value >> 27 & 31) << 11 | (value >> 19 & 31) << 6 | (value >> 11 & 31) << 1 | (value >> 7 & 1);
+    if(state.alphaCompare && !(value & 1)) return;
+    rdram.ram.write<Half>(address, value, nullptr);
+    break;
+  case 3: {
+    auto color = unpack(state, tile, texel(state, tile, s, t));
+    rdram.ram.write<Word>(address, (u32)color.r << 24 | color.g << 16 | color.b << 8 | color.a, nullptr);
+  } break;
+  }
+}
+
+//depth is 18-bit internally, and stored as a 3-bit exponent (the count of leading ones) and 11-bit mantissa.
+//the lower two bits of the stored value hold the depth slope, which is not emulated.
+auto RDP::Software::compress(u32 z) -> u32 {
+  u32 exponent = 0;
+  while(exponent < 7 && z >> (17 - exponent) & 1) exponent++;
+  u32 mantissa = z >> (exponent < 6 ? 6 - exponent : 0) & 0x7ff;
+  return (exponent << 11 | mantissa) << 2;
+}
+
+auto RDP::Software::decompress(u32 z) -> u32 {
+  u32 exponent = z >> 13 & 7;
+  u32 mantissa = z >> 2 & 0x7ff;
+  u32 base = exponent ? 0x40000 - (0x40000 >> exponent) : 0;
+  return base + (mantissa << (exponent < 6 ? 6 - exponent : 0));
+}
+
+//texture coordinate shifts: 1-10 are right shifts, 11-15 are left shifts of 5-1.
+auto RDP::Software::shift(s32 coordinate, u32 shift) -> s32 {
+  return shift < 11 ? coordinate >> shift : coordinate << (16 - shift);
+}
+
+//clamps, mirrors and masks an integer texel coordinate relative to the tile origin.
+auto RDP::Software::wrap(s32 coordinate, const Tile::Axis& axis) -> u32 {
+  if(axis.clamp || !axis.mask) coordinate = max(0, min(coordinate, ((s32)axis.hi - (s32)axis.lo) >> 2));
+  if(axis.mask) {
+    u32 mask = min(axis.mask, 10u);
+    if(axis.mirror && coordinate >> mask & 1) coordinate = ~coordinate;
+    coordinate &= (1 << mask) - 1;
+  }
+  return coordinate;
+}
+
+//clamps a 9-bit result as the RDP does: 0x100-0x17f overflow to 255, 0x180-0x1ff underflow to 0.
+auto RDP::Software::saturate(s32 value) -> s32 {
+  value &= 0x1ff;
+  if(value & 0x100) return value & 0x80 ? 0 : 255;
+  return value;
+}
+
+//the noise input; a hash of the pixel position and primitive, so that it is the same on every thread.
+auto RDP::Software::random(s32 x, s32 y, u32 seed) -> u32 {
+  u32 hash = x * 0x9e3779b1 ^ y * 0x85ebca6b ^ seed * 0xc2b2ae35;
+  hash ^= hash >> 15;
+  hash *= 0x2c1b3c6d;
+  hash ^= hash >> 12;
+  return hash;
+}
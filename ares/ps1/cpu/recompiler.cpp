@@ -140,6 +140,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //ADDIU Rt,Rs,i16
   case 0x09: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(i16));
@@ -149,6 +150,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //SLTI Rt,Rs,i16
   case 0x0a: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(i16));
@@ -158,6 +160,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //SLTIU Rt,Rs,i16
   case 0x0b: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(i16));
@@ -167,6 +170,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //ANDI Rt,Rs,n16
   case 0x0c: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(n16));
@@ -176,6 +180,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //ORI Rt,Rs,n16
   case 0x0d: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(n16));
@@ -185,6 +190,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //XORI Rt,Rs,n16
   case 0x0e: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     lea(reg(2), Rs);
     mov32(reg(3), imm(n16));
@@ -194,6 +200,7 @@ auto CPU::Recompiler::emitEXECUTE(u32 instruction) -> bool {
 
   //LUI Rt,n16
   case 0x0f: {
+    if(Rtn == 0) return 0;
     lea(reg(1), Rt);
     mov32(reg(2), imm(n16));
     call(&CPU::LUI);
@@ -448,6 +455,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SLL Rd,Rt,Sa
   case 0x00: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     mov32(reg(3), imm(Sa));
@@ -463,6 +471,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SRL Rd,Rt,Sa
   case 0x02: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     mov32(reg(3), imm(Sa));
@@ -472,6 +481,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SRA Rd,Rt,Sa
   case 0x03: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     mov32(reg(3), imm(Sa));
@@ -481,6 +491,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SLLV Rd,Rt,Rs
   case 0x04: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     lea(reg(3), Rs);
@@ -496,6 +507,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SRLV Rd,Rt,Rs
   case 0x06: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     lea(reg(3), Rs);
@@ -505,6 +517,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SRAV Rd,Rt,Rs
   case 0x07: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rt);
     lea(reg(3), Rs);
@@ -634,6 +647,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //ADDU Rd,Rs,Rt
   case 0x21: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -652,6 +666,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SUBU Rd,Rs,Rt
   case 0x23: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -661,6 +676,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //AND Rd,Rs,Rt
   case 0x24: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -670,6 +686,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //OR Rd,Rs,Rt
   case 0x25: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -679,6 +696,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //XOR Rd,Rs,Rt
   case 0x26: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -688,6 +706,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //NOR Rd,Rs,Rt
   case 0x27: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -703,6 +722,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SLT Rd,Rs,Rt
   case 0x2a: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
@@ -712,6 +732,7 @@ auto CPU::Recompiler::emitSPECIAL(u32 instruction) -> bool {
 
   //SLTU Rd,Rs,Rt
   case 0x2b: {
+    if(Rdn == 0) return 0;
     lea(reg(1), Rd);
     lea(reg(2), Rs);
     lea(reg(3), Rt);
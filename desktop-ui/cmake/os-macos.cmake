@@ -33,6 +33,7 @@ else()
   target_add_resource(desktop-ui "${CMAKE_CURRENT_SOURCE_DIR}/resource/AppIcon.icns")
 endif()
 target_add_resource(desktop-ui "${CMAKE_SOURCE_DIR}/ares/fc/apu/dmc.bml")
+target_add_resource(desktop-ui "${CMAKE_SOURCE_DIR}/ares/fc/apu/dmc.db")
 
 function(target_install_shaders target)
   message(DEBUG "Installing shaders for target ${target}...")
@@ -14,6 +14,7 @@ target_sources(
   PRIVATE
     program/drivers.cpp
     program/load.cpp
+    program/midi.cpp
     program/platform.cpp
     program/program.hpp
     program/rewind.cpp
@@ -90,6 +90,10 @@ auto nall::main(Arguments arguments) -> void {
     program.noFilePrompt = true;
   }
 
+  if(string location; arguments.take("--record-midi", location)) {
+    program.midiRecorder.location = location;
+  }
+
   inputManager.create();
   Emulator::construct();
   settings.load();
@@ -127,6 +131,7 @@ auto nall::main(Arguments arguments) -> void {
     print("  --setting name=value Specify a value for a setting\n");
     print("  --dump-all-settings  Show a list of all existing settings and exit\n");
     print("  --no-file-prompt     Do not prompt to load (optional) additional roms (eg: 64DD)\n");
+    print("  --record-midi file   Record MIDI output to a Standard MIDI File\n");
     print("\n");
     print("Available Systems:\n");
     print("  ");
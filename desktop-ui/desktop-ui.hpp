@@ -10,6 +10,7 @@ using namespace hiro;
 #include <mia/mia.hpp>
 
 #include <nall/instance.hpp>
+#include <nall/encode/midi.hpp>
 #include <nall/encode/png.hpp>
 #include <nall/hash/crc16.hpp>
 
@@ -23,6 +24,7 @@ namespace ruby {
 #include "input/input.hpp"
 #include "emulator/emulator.hpp"
 #include "game-browser/game-browser.hpp"
+#include "program/rewind.hpp"
 #include "program/program.hpp"
 #include "presentation/presentation.hpp"
 #include "settings/settings.hpp"
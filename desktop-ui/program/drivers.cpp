@@ -72,6 +72,7 @@ auto Program::audioDriverUpdate() -> void {
   ruby::audio.create(settings.audio.driver);
   ruby::audio.setContext(presentation.viewport.handle());
   audioDeviceUpdate();
+  audioMIDIDeviceUpdate();
   audioFrequencyUpdate();
   audioLatencyUpdate();
   ruby::audio.setExclusive(settings.audio.exclusive);
@@ -92,6 +93,13 @@ auto Program::audioDeviceUpdate() -> void {
   ruby::audio.setDevice(settings.audio.device);
 }
 
+auto Program::audioMIDIDeviceUpdate() -> void {
+  if(!ruby::audio.hasMIDIDevice(settings.audio.midiDevice)) {
+    settings.audio.midiDevice = ruby::audio.midiDevice();
+  }
+  ruby::audio.setMIDIDevice(settings.audio.midiDevice);
+}
+
 auto Program::audioFrequencyUpdate() -> void {
   if(!ruby::audio.hasFrequency(settings.audio.frequency)) {
     settings.audio.frequency = ruby::audio.frequency();
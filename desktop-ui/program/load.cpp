@@ -58,6 +58,7 @@ auto Program::load(string location) -> bool {
 
   paletteUpdate();
   runAheadUpdate();
+  midiRecordStart();
   presentation.loadEmulator();
   presentation.showIcon(false);
   if(settings.video.adaptiveSizing) presentation.resizeWindow();
@@ -103,8 +104,11 @@ auto Program::unload() -> void {
   clearUndoStates();
   showMessage({"Unloaded ", Location::prefix(emulator->game->location)});
   emulator->unload();
+  midiRecordStop();
   screens.reset();
   streams.reset();
+  midis.reset();
+  runAheadState = {};
   emulator.reset();
   rewindReset();
   presentation.unloadEmulator();
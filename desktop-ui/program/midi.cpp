@@ -0,0 +1,58 @@
+//records the MIDI node output as a Standard MIDI File.
+//events are stamped with emulated time, so recordings are identical at any emulation speed,
+//and they are captured whether or not a MIDI output device is attached.
+
+auto Program::midiRecordStart() -> void {
+  midiRecordStop();
+  midiRecorder.origin = nothing;
+}
+
+auto Program::midiRecordStop() -> void {
+  if(!midiRecorder.file) return;
+  if(!midiRecorder.file.close()) {
+    print("Failed to write MIDI recording: ", midiRecorder.location, "\n");
+  }
+}
+
+auto Program::midiRecord(ares::Node::Audio::MIDI node) -> void {
+  if(!midiRecorder.location) return;
+  if(!midiRecorder.origin) {
+    //the file is opened on the first batch, once the node has named its tracks
+    auto& tracks = node->tracks();
+    u32 count = min<u32>(tracks.size(), Encode::MIDI::Tracks);
+    if(!midiRecorder.file.open(midiRecorder.location, count, MIDIRecorder::Division)) {
+      print("Failed to create MIDI recording: ", midiRecorder.location, "\n");
+      midiRecorder.location = {};
+      return;
+    }
+    midiRecorder.file.tempo(0, MIDIRecorder::Tempo);
+    for(u32 track : range(count)) midiRecorder.file.name(track, tracks[track]);
+    midiRecorder.origin = node->timestamp();
+  }
+  if(!midiRecorder.file) return;
+
+  //ticks per second = division * 1'000'000 / tempo
+  f64 ticksPerSample = MIDIRecorder::Division * 1'000'000.0 / MIDIRecorder::Tempo / node->frequency();
+  for(auto& event : node->events()) {
+    u64 tick = (event.timestamp - midiRecorder.origin()) * ticksPerSample + 0.5;
+    midiRecorder.file.write(event.track, tick, event.message);
+  }
+}
+
+//applies the bandwidth limit setting to the running emulator; newly attached nodes pick it up in Program::attach().
+auto Program::midiSchedulerUpdate() -> void {
+  for(auto& midi : midis) {
+    midi->setScheduler(settings.audio.midiScheduler);
+  }
+}
+
+//returns the number of MIDI messages sent since the previous call, or nothing if the system has no MIDI output.
+auto Program::midiMessageRate() -> maybe<u64> {
+  if(!midis) return nothing;
+  u64 messages = 0;
+  for(auto& midi : midis) messages += midi->telemetry().messages();
+  //counters restart whenever a system is loaded:
+  u64 rate = messages >= midiMessages ? messages - midiMessages : messages;
+  midiMessages = messages;
+  return rate;
+}
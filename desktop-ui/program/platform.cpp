@@ -7,6 +7,11 @@ auto Program::attach(ares::Node::Object node) -> void {
     streams = emulator->root->find<ares::Node::Audio::Stream>();
     stream->setResamplerFrequency(ruby::audio.frequency());
   }
+
+  if(auto midi = node->cast<ares::Node::Audio::MIDI>()) {
+    midis = emulator->root->find<ares::Node::Audio::MIDI>();
+    midi->setScheduler(settings.audio.midiScheduler);
+  }
 }
 
 auto Program::detach(ares::Node::Object node) -> void {
@@ -20,6 +25,11 @@ auto Program::detach(ares::Node::Object node) -> void {
     streams.removeByValue(stream);
     stream->setResamplerFrequency(ruby::audio.frequency());
   }
+
+  if(auto midi = node->cast<ares::Node::Audio::MIDI>()) {
+    midis = emulator->root->find<ares::Node::Audio::MIDI>();
+    midis.removeByValue(midi);
+  }
 }
 
 auto Program::pak(ares::Node::Object node) -> shared_pointer<vfs::directory> {
@@ -58,7 +68,10 @@ auto Program::status(string_view message) -> void {
 }
 
 auto Program::video(ares::Node::Video::Screen node, const u32* data, u32 pitch, u32 width, u32 height) -> void {
-  if(!screens) return;
+  if(!screens) {
+    if(data == videoLent) videoLent = nullptr, ruby::video.release(), ruby::video.unlock();
+    return;
+  }
 
   if(requestScreenshot) {
     requestScreenshot = false;
@@ -111,7 +124,13 @@ auto Program::video(ares::Node::Video::Screen node, const u32* data, u32 pitch,
   }
 
   pitch >>= 2;
-  if(auto [output, length] = ruby::video.acquire(width, height); output) {
+  if(data == videoLent) {
+    //the screen rendered straight into the driver's buffer; it only needs to be presented.
+    videoLent = nullptr;
+    ruby::video.release();
+    ruby::video.output(outputWidth, outputHeight);
+    ruby::video.unlock();  //held since videoBuffer()
+  } else if(auto [output, length] = ruby::video.acquire(width, height); output) {
     length >>= 2;
     for(auto y : range(height)) {
       memory::copy<u32>(output + y * length, data + y * pitch, width);
@@ -132,6 +151,21 @@ auto Program::video(ares::Node::Video::Screen node, const u32* data, u32 pitch,
   }
 }
 
+//lends the video driver's buffer so that the screen can render into it without an extra copy.
+//the driver stays locked until video() presents the frame.
+auto Program::videoBuffer(ares::Node::Video::Screen node, u32 width, u32 height) -> ares::VideoBuffer {
+  //screenshots read the frame back, which can be slow from driver memory
+  if(!screens || requestScreenshot || videoLent) return {};
+  ruby::video.lock();
+  auto [output, length] = ruby::video.acquire(width, height);
+  if(!output) {
+    ruby::video.unlock();
+    return {};
+  }
+  videoLent = output;
+  return {output, length};
+}
+
 auto Program::refreshRateHint(double refreshRate) -> void {
   ruby::video.refreshRateHint(refreshRate);
 }
@@ -176,8 +210,17 @@ auto Program::audio(ares::Node::Audio::Stream node) -> void {
 }
 
 auto Program::midi(ares::Node::Audio::MIDI node) -> void {
-  s32 msg = node->readShort();
-  ruby::audio.midiShort(msg);
+  midiRecord(node);
+
+  //convert emulated sample timestamps into offsets from the start of this batch
+  auto& events = node->events();
+  vector<ruby::MIDIEvent> batch;
+  batch.resize(events.size());
+  for(u32 n : range(events.size())) {
+    batch[n].offset = (events[n].timestamp - node->timestamp()) * 1'000'000.0 / node->frequency();
+    batch[n].message = events[n].message;
+  }
+  ruby::audio.midi(batch.data(), batch.size());
 }
 
 auto Program::input(ares::Node::Input::Input node) -> void {
@@ -1,6 +1,7 @@
 #include "../desktop-ui.hpp"
 #include "platform.cpp"
 #include "load.cpp"
+#include "midi.cpp"
 #include "states.cpp"
 #include "rewind.cpp"
 #include "status.cpp"
@@ -83,11 +84,17 @@ auto Program::main() -> void {
   } else {
     ares::setRunAhead(true);
     emulator->root->run();
-    auto state = emulator->root->serialize(false);
+    emulator->root->serialize(runAheadState, false);
+    //speculative frames replay the current input; only the last one is presented:
+    for(auto& midi : midis) midi->setSpeculative(true);
+    for(u32 frame : range(runAheadFrames)) {
+      ares::setRunAhead(frame + 1 < runAheadFrames);
+      emulator->root->run();
+    }
     ares::setRunAhead(false);
-    emulator->root->run();
-    state.setReading();
-    emulator->root->unserialize(state);
+    for(auto& midi : midis) midi->setSpeculative(false);
+    runAheadState.setReading();
+    emulator->root->unserialize(runAheadState);
   }
 
   nall::GDB::server.updateLoop();
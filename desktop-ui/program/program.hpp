@@ -11,6 +11,7 @@ struct Program : ares::Platform {
   auto log(ares::Node::Debugger::Tracer::Tracer tracer, string_view message) -> void override;
   auto status(string_view message) -> void override;
   auto video(ares::Node::Video::Screen, const u32* data, u32 pitch, u32 width, u32 height) -> void override;
+  auto videoBuffer(ares::Node::Video::Screen, u32 width, u32 height) -> ares::VideoBuffer override;
   auto refreshRateHint(double refreshRate) -> void override;
   auto audio(ares::Node::Audio::Stream) -> void override;
   auto midi(ares::Node::Audio::MIDI) -> void override;
@@ -23,6 +24,13 @@ struct Program : ares::Platform {
   auto load(string location) -> bool;
   auto unload() -> void;
 
+  //midi.cpp
+  auto midiRecordStart() -> void;
+  auto midiRecordStop() -> void;
+  auto midiRecord(ares::Node::Audio::MIDI) -> void;
+  auto midiSchedulerUpdate() -> void;
+  auto midiMessageRate() -> maybe<u64>;
+
   //states.cpp
   auto stateSave(u32 slot) -> bool;
   auto stateLoad(u32 slot) -> bool;
@@ -52,6 +60,7 @@ struct Program : ares::Platform {
 
   auto audioDriverUpdate() -> void;
   auto audioDeviceUpdate() -> void;
+  auto audioMIDIDeviceUpdate() -> void;
   auto audioFrequencyUpdate() -> void;
   auto audioLatencyUpdate() -> void;
 
@@ -66,14 +75,19 @@ struct Program : ares::Platform {
 
   vector<ares::Node::Video::Screen> screens;
   vector<ares::Node::Audio::Stream> streams;
+  vector<ares::Node::Audio::MIDI> midis;
 
   bool paused = false;
   bool fastForwarding = false;
   bool rewinding = false;
   bool runAhead = false;
+  static constexpr u32 RunAheadFramesMaximum = 4;
+  u32 runAheadFrames = 1;
   bool requestFrameAdvance = false;
   bool requestScreenshot = false;
   bool keyboardCaptured = false;
+  serializer runAheadState;  //reused every frame, so that only the memory pages written since are copied
+  u32* videoLent = nullptr;  //driver buffer lent to the screen by videoBuffer(), until video() presents it
 
   struct State {
     u32 slot = 1;
@@ -83,7 +97,8 @@ struct Program : ares::Platform {
   //rewind.cpp
   struct Rewind {
     enum class Mode : u32 { Playing, Rewinding } mode = Mode::Playing;
-    vector<serializer> history;
+    RewindHistory history;
+    serializer state;           //reused for every snapshot, so that only the memory pages written since are copied
     u32 length = 0;
     u32 frequency = 0;
     u32 counter = 0;
@@ -92,6 +107,14 @@ struct Program : ares::Platform {
   auto rewindReset() -> void;
   auto rewindRun() -> void;
 
+  struct MIDIRecorder {
+    static constexpr u32 Division = 960;     //ticks per quarter note
+    static constexpr u32 Tempo = 500'000;  //microseconds per quarter note (120 BPM)
+    Encode::MIDI file;
+    string location;
+    maybe<u64> origin;  //node timestamp at the start of the recording
+  } midiRecorder;
+
   struct Message {
     u64 timestamp = 0;
     string text;
@@ -99,6 +122,7 @@ struct Program : ares::Platform {
 
   vector<Message> messages;
   maybe<u64> vblanksPerSecond;
+  u64 midiMessages = 0;  //MIDI telemetry message count at the previous poll
 };
 
 extern Program program;
@@ -6,6 +6,7 @@ auto Program::rewindSetMode(Rewind::Mode mode) -> void {
 auto Program::rewindReset() -> void {
   rewindSetMode(Rewind::Mode::Playing);
   rewind.history.reset();
+  rewind.state = {};
   rewind.length = settings.rewind.length;
   rewind.frequency = settings.rewind.frequency;
 }
@@ -16,16 +17,16 @@ auto Program::rewindRun() -> void {
   if(rewind.mode == Rewind::Mode::Playing) {
     if(++rewind.counter < rewind.frequency) return;
     rewind.counter = 0;
-    if(rewind.history.size() >= rewind.length) rewind.history.takeFirst();
-    auto s = emulator->root->serialize(0);
-    rewind.history.append(s);
+    emulator->root->serialize(rewind.state, false);
+    rewind.history.save(rewind.state.data(), rewind.state.size(), rewind.length);
   }
 
   if(rewind.mode == Rewind::Mode::Rewinding) {
-    if(!rewind.history.size()) return rewindSetMode(Rewind::Mode::Playing);  //nothing left to rewind?
+    if(!rewind.history) return rewindSetMode(Rewind::Mode::Playing);  //nothing left to rewind?
     if(++rewind.counter < rewind.frequency / 5) return;  //rewind 5x faster than playing
     rewind.counter = 0;
-    auto s = rewind.history.takeLast();
+    auto snapshot = rewind.history.load();
+    serializer s{snapshot.data(), (u32)snapshot.size()};
     s.setReading();
     emulator->root->unserialize(s);
     if(!rewind.history) {
@@ -0,0 +1,158 @@
+//rewind history lives in a single ring buffer that is allocated once per game.
+//every Keyframe-th snapshot is stored whole; the others are stored as their XOR against the preceding keyframe,
+//with runs of unchanged (zero) bytes skipped, so that they take space in proportion to what changed.
+//when the buffer is full, the oldest snapshots are evicted along with any deltas that depend on them.
+//the buffer is sized to hold the requested number of snapshots stored whole, as if no snapshot were a delta;
+//deltas leave room for more, so the history grows past that number for as long as space allows.
+
+struct RewindHistory {
+  static constexpr u32 Keyframe = 16;  //at most this many snapshots per keyframe
+
+  struct Snapshot {
+    u32 offset;  //position of the encoded snapshot in buffer
+    u32 size;    //encoded size
+    u32 length;  //serialized state size
+    bool keyframe;
+  };
+
+  explicit operator bool() const { return (bool)history; }
+  auto size() const -> u32 { return history.size(); }
+  auto capacity() const -> u64 { return buffer.size(); }
+  auto snapshots() const -> const vector<Snapshot>& { return history; }
+
+  auto reset() -> void {
+    buffer.reset();
+    history.reset();
+    scratch.reset();
+    head = 0;
+  }
+
+  //stores a snapshot, for a history of at least length snapshots.
+  auto save(const u8* data, u32 size, u32 length) -> void {
+    if(!buffer) {
+      buffer.resize(min((u64)size * max(1u, length), (u64)0xffff'ffff));
+      history.reserve(length);
+    }
+    //the count is bounded only to keep history in proportion to the buffer, for states that barely change:
+    if(history.size() >= (u64)length * Keyframe) evict();
+
+    bool delta = false;
+    if(auto keyframe = this->keyframe()) {
+      encode(scratch, data, size, buffer.data() + keyframe->offset, keyframe->length);
+      //a delta that saves little is not worth depending on an old keyframe:
+      delta = scratch.size() < size / 2;
+    }
+
+    auto offset = allocate(delta ? scratch.size() : size);
+    //making room may have evicted the keyframe, and with it every delta against it:
+    if(delta && !history) delta = false, offset = allocate(size);
+    if(!offset) return;
+
+    u32 encoded = delta ? scratch.size() : size;
+    memory::copy(buffer.data() + *offset, delta ? scratch.data() : data, encoded);
+    history.append({*offset, encoded, size, !delta});
+    head = *offset + encoded;
+  }
+
+  //removes the most recent snapshot, and returns its contents.
+  //the result remains valid until the next call to save() or load().
+  auto load() -> array_view<u8> {
+    auto snapshot = history.takeLast();
+    head = history ? snapshot.offset : 0;
+    const u8* input = buffer.data() + snapshot.offset;
+    if(snapshot.keyframe) return {input, snapshot.length};
+
+    auto keyframe = this->keyframe();
+    scratch.resize(snapshot.length);
+    decode(scratch.data(), snapshot.length, input, buffer.data() + keyframe->offset, keyframe->length);
+    return {scratch.data(), snapshot.length};
+  }
+
+private:
+  //returns the keyframe that the next snapshot would be encoded against, if it may still be used.
+  auto keyframe() -> maybe<Snapshot&> {
+    for(u32 n : range(min(history.size(), Keyframe))) {
+      auto& snapshot = history[history.size() - 1 - n];
+      if(snapshot.keyframe) return snapshot;
+    }
+    return nothing;
+  }
+
+  //finds room for size contiguous bytes, evicting the oldest snapshots as needed.
+  auto allocate(u32 size) -> maybe<u32> {
+    if(size > buffer.size()) return nothing;
+    while(history) {
+      u32 tail = history.first().offset;
+      if(head > tail) {
+        if(buffer.size() - head >= size) return head;
+        if(tail >= size) return 0;
+      } else if(tail - head >= size) {
+        return head;
+      }
+      evict();
+    }
+    return head = 0;
+  }
+
+  //removes the oldest snapshot, and the deltas that can no longer be decoded without it.
+  auto evict() -> void {
+    do history.removeLeft();
+    while(history && !history.first().keyframe);
+    if(!history) head = 0;
+  }
+
+  static auto writeLength(vector<u8>& output, u32 value) -> void {
+    while(value >= 0x80) output.append(value & 0x7f | 0x80), value >>= 7;
+    output.append(value);
+  }
+
+  static auto readLength(const u8*& input) -> u32 {
+    u32 value = 0;
+    for(u32 shift = 0; ; shift += 7) {
+      u8 byte = *input++;
+      value |= (byte & 0x7f) << shift;
+      if(!(byte & 0x80)) return value;
+    }
+  }
+
+  //encodes data ^ key as alternating lengths of unchanged and changed bytes, followed by the changed bytes.
+  static auto encode(vector<u8>& output, const u8* data, u32 size, const u8* key, u32 keySize) -> void {
+    auto same = [&](u32 offset) { return data[offset] == (offset < keySize ? key[offset] : 0); };
+    u32 limit = min(size, keySize);
+    u32 offset = 0;
+    output.resize(0);
+    while(offset < size) {
+      u32 start = offset;
+      while(offset + 8 <= limit && memory::readl<8>(data + offset) == memory::readl<8>(key + offset)) offset += 8;
+      while(offset < size && same(offset)) offset++;
+      writeLength(output, offset - start);
+
+      //a changed run ends at eight unchanged bytes, which are cheaper to skip than to store:
+      start = offset;
+      u32 unchanged = 0;
+      while(offset < size && unchanged < 8) {
+        unchanged = same(offset) ? unchanged + 1 : 0;
+        offset++;
+      }
+      if(unchanged == 8) offset -= 8;
+      writeLength(output, offset - start);
+      for(u32 n = start; n < offset; n++) output.append(data[n] ^ (n < keySize ? key[n] : 0));
+    }
+  }
+
+  static auto decode(u8* data, u32 size, const u8* input, const u8* key, u32 keySize) -> void {
+    memory::copy(data, key, min(size, keySize));
+    if(size > keySize) memory::fill(data + keySize, size - keySize);
+    u32 offset = 0;
+    while(offset < size) {
+      offset += readLength(input);
+      u32 changed = readLength(input);
+      while(changed--) data[offset++] ^= *input++;
+    }
+  }
+
+  vector<u8> buffer;         //ring buffer holding every encoded snapshot, allocated once
+  vector<Snapshot> history;  //oldest first
+  vector<u8> scratch;        //encoding workspace
+  u32 head = 0;              //offset in buffer at which the next snapshot is written
+};
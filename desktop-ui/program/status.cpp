@@ -9,7 +9,9 @@ auto Program::updateMessage() -> void {
   }
 
   if(vblanksPerSecond) {
-    presentation.statusRight.setText({vblanksPerSecond(), " VPS"});
+    string status = {vblanksPerSecond(), " VPS"};
+    if(auto messages = midiMessageRate()) status.append(", ", messages(), " MIDI/s");
+    presentation.statusRight.setText(status);
     vblanksPerSecond.reset();
   }
 
@@ -25,6 +25,7 @@ auto Program::paletteUpdate() -> void {
 
 auto Program::runAheadUpdate() -> void {
   runAhead = settings.general.runAhead;
+  runAheadFrames = min(max(1u, settings.general.runAheadFrames), RunAheadFramesMaximum);
   if(!emulator) return;
   if(emulator->name == "Game Boy Advance") runAhead = false;  //crashes immediately
   if(emulator->name == "Nintendo 64") runAhead = false;  //too demanding
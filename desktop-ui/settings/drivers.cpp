@@ -76,6 +76,12 @@ auto DriverSettings::construct() -> void {
     program.audioDeviceUpdate();
     audioRefresh();
   });
+  audioMIDIDeviceLabel.setText("MIDI device:");
+  audioMIDIDeviceList.onChange([&] {
+    settings.audio.midiDevice = audioMIDIDeviceList.selected().text();
+    program.audioMIDIDeviceUpdate();
+    audioRefresh();
+  });
   audioFrequencyLabel.setText("Frequency:");
   audioFrequencyList.onChange([&] {
     settings.audio.frequency = audioFrequencyList.selected().text().natural();
@@ -100,6 +106,10 @@ auto DriverSettings::construct() -> void {
     settings.audio.dynamic = audioDynamicToggle.checked();
     ruby::audio.setDynamic(settings.audio.dynamic);
   });
+  audioMIDISchedulerToggle.setText("Limit MIDI bandwidth").onToggle([&] {
+    settings.audio.midiScheduler = audioMIDISchedulerToggle.checked();
+    program.midiSchedulerUpdate();
+  });
 
   inputLabel.setText("Input").setFont(Font().setBold());
   inputDriverList.onChange([&] {
@@ -204,6 +214,12 @@ auto DriverSettings::audioRefresh() -> void {
     item.setText(device);
     if(device == ruby::audio.device()) item.setSelected();
   }
+  audioMIDIDeviceList.reset();
+  for(auto& device : ruby::audio.hasMIDIDevices()) {
+    ComboButtonItem item{&audioMIDIDeviceList};
+    item.setText(device);
+    if(device == ruby::audio.midiDevice()) item.setSelected();
+  }
   audioFrequencyList.reset();
   for(auto& frequency : ruby::audio.hasFrequencies()) {
     ComboButtonItem item{&audioFrequencyList};
@@ -217,9 +233,11 @@ auto DriverSettings::audioRefresh() -> void {
     if(latency == ruby::audio.latency()) item.setSelected();
   }
   audioDeviceList.setEnabled(audioDeviceList.itemCount() > 1);
+  audioMIDIDeviceList.setEnabled(audioMIDIDeviceList.itemCount() > 1);
   audioExclusiveToggle.setChecked(ruby::audio.exclusive()).setEnabled(ruby::audio.hasExclusive());
   audioBlockingToggle.setChecked(ruby::audio.blocking()).setEnabled(ruby::audio.hasBlocking());
   audioDynamicToggle.setChecked(ruby::audio.dynamic()).setEnabled(ruby::audio.hasDynamic());
+  audioMIDISchedulerToggle.setChecked(settings.audio.midiScheduler);
   VerticalLayout::resize();
 }
 
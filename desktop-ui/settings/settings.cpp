@@ -82,6 +82,8 @@ auto Settings::process(bool load) -> void {
 
   bind(string,  "Audio/Driver", audio.driver);
   bind(string,  "Audio/Device", audio.device);
+  bind(string,  "Audio/MIDIDevice", audio.midiDevice);
+  bind(boolean, "Audio/MIDIScheduler", audio.midiScheduler);
   bind(natural, "Audio/Frequency", audio.frequency);
   bind(natural, "Audio/Latency", audio.latency);
   bind(boolean, "Audio/Exclusive", audio.exclusive);
@@ -101,6 +103,7 @@ auto Settings::process(bool load) -> void {
   bind(boolean, "General/ShowStatusBar", general.showStatusBar);
   bind(boolean, "General/Rewind", general.rewind);
   bind(boolean, "General/RunAhead", general.runAhead);
+  bind(natural, "General/RunAheadFrames", general.runAheadFrames);
   bind(boolean, "General/AutoSaveMemory", general.autoSaveMemory);
   bind(boolean, "General/HomebrewMode", general.homebrewMode);
   bind(boolean, "General/ForceInterpreter", general.forceInterpreter);
@@ -41,6 +41,8 @@ struct Settings : Markup::Node {
   struct Audio {
     string driver;
     string device;
+    string midiDevice;
+    bool midiScheduler = false;
     u32 frequency = 0;
     u32 latency = 0;
     bool exclusive = false;
@@ -67,6 +69,7 @@ struct Settings : Markup::Node {
     bool showStatusBar = true;
     bool rewind = false;
     bool runAhead = false;
+    u32 runAheadFrames = 1;
     bool autoSaveMemory = true;
     bool homebrewMode = false;
     bool forceInterpreter = false;
@@ -250,6 +253,7 @@ struct OptionSettings : VerticalLayout {
       Label rewindHint{&rewindLayout, Size{~0, 0}};
     HorizontalLayout runAheadLayout{this, Size{~0, 0}, 5};
       CheckLabel runAhead{&runAheadLayout, Size{0, 0}, 5};
+      ComboButton runAheadFrames{&runAheadLayout, Size{0, 0}};
       Label runAheadHint{&runAheadLayout, Size{~0, 0}};
     HorizontalLayout autoSaveMemoryLayout{this, Size{~0, 0}, 5};
       CheckLabel autoSaveMemory{&autoSaveMemoryLayout, Size{0, 0}, 5};
@@ -374,6 +378,8 @@ struct DriverSettings : VerticalLayout {
   HorizontalLayout audioDeviceLayout{this, Size{~0, 0}};
     Label audioDeviceLabel{&audioDeviceLayout, Size{0, 0}};
     ComboButton audioDeviceList{&audioDeviceLayout, Size{0, 0}};
+    Label audioMIDIDeviceLabel{&audioDeviceLayout, Size{0, 0}};
+    ComboButton audioMIDIDeviceList{&audioDeviceLayout, Size{0, 0}};
   HorizontalLayout audioPropertyLayout{this, Size{~0, 0}};
     Label audioFrequencyLabel{&audioPropertyLayout, Size{0, 0}};
     ComboButton audioFrequencyList{&audioPropertyLayout, Size{0, 0}};
@@ -383,6 +389,7 @@ struct DriverSettings : VerticalLayout {
     CheckLabel audioExclusiveToggle{&audioToggleLayout, Size{0, 0}};
     CheckLabel audioBlockingToggle{&audioToggleLayout, Size{0, 0}};
     CheckLabel audioDynamicToggle{&audioToggleLayout, Size{0, 0}};
+    CheckLabel audioMIDISchedulerToggle{&audioToggleLayout, Size{0, 0}};
   //
   Label inputLabel{this, Size{~0, 0}, 5};
   HorizontalLayout inputDriverLayout{this, Size{~0, 0}};
@@ -133,6 +133,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)((uintptr_t*)handle)[0];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -179,6 +179,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)((long long*)handle)[0];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -79,6 +79,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)((unsigned long*)handle)[8];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -429,3 +429,7 @@ void co_switch(cothread_t t) {
 int co_serializable() {
   return 0;
 }
+
+void* co_stack_pointer(cothread_t handle) {
+  return 0;
+}
@@ -275,6 +275,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)((struct ppc64_context*)handle)->gprs[1];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -145,6 +145,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)(uintptr_t)((uint64_t*)handle)[1];
+}
+
 #ifdef __cplusplus
 }
 #endif
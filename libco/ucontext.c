@@ -81,6 +81,10 @@ int co_serializable() {
   return 0;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
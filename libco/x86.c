@@ -114,6 +114,10 @@ int co_serializable() {
   return 1;
 }
 
+void* co_stack_pointer(cothread_t handle) {
+  return (void*)((long*)handle)[0];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,9 @@ struct Biquad {
   auto reset(Type type, f64 cutoffFrequency, f64 samplingFrequency, f64 quality, f64 gain = 0.0) -> void;
   auto process(f64 in) -> f64;  //normalized sample (-1.0 to +1.0)
 
+  struct Coefficients { f64 a0, a1, a2, b1, b2; };
+  auto coefficients() const -> Coefficients { return {a0, a1, a2, b1, b2}; }
+
   static auto shelf(f64 gain, f64 slope) -> f64;
   static auto butterworth(u32 order, u32 phase) -> f64;
 
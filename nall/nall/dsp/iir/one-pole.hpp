@@ -13,6 +13,9 @@ struct OnePole {
   auto reset(Type type, f64 cutoffFrequency, f64 samplingFrequency) -> void;
   auto process(f64 in) -> f64;  //normalized sample (-1.0 to +1.0)
 
+  struct Coefficients { f64 a0, b1; };
+  auto coefficients() const -> Coefficients { return {a0, b1}; }
+
 private:
   Type type;
   f64 cutoffFrequency;
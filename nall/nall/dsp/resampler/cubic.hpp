@@ -1,5 +1,6 @@
 #pragma once
 
+#include <nall/array-view.hpp>
 #include <nall/queue.hpp>
 #include <nall/serializer.hpp>
 
@@ -14,6 +15,7 @@ struct Cubic {
   auto pending() const -> bool;
   auto read() -> f64;
   auto write(f64 sample) -> void;
+  auto write(array_view<f64> samples) -> void;
   auto serialize(serializer&) -> void;
 
 private:
@@ -71,6 +73,35 @@ inline auto Cubic::write(f64 sample) -> void {
   mu -= 1.0;
 }
 
+//equivalent to writing each sample in turn, but keeps the interpolation state in registers:
+//otherwise it has to be reloaded after every store to the output queue, which may alias it.
+inline auto Cubic::write(array_view<f64> samples) -> void {
+  f64 mu = _fraction;
+  f64 s0 = _history[0], s1 = _history[1], s2 = _history[2], s3 = _history[3];
+
+  for(f64 sample : samples) {
+    s0 = s1;
+    s1 = s2;
+    s2 = s3;
+    s3 = sample;
+
+    while(mu <= 1.0) {
+      f64 A = s3 - s2 - s0 + s1;
+      f64 B = s0 - s1 - A;
+      f64 C = s2 - s0;
+      f64 D = s1;
+
+      _samples.write(A * mu * mu * mu + B * mu * mu + C * mu + D);
+      mu += _ratio;
+    }
+
+    mu -= 1.0;
+  }
+
+  _fraction = mu;
+  _history[0] = s0, _history[1] = s1, _history[2] = s2, _history[3] = s3;
+}
+
 inline auto Cubic::serialize(serializer& s) -> void {
   s(_inputFrequency);
   s(_outputFrequency);
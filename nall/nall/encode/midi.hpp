@@ -0,0 +1,127 @@
+#pragma once
+
+#include <nall/file.hpp>
+#include <nall/file-buffer.hpp>
+
+namespace nall::Encode {
+
+//streaming Standard MIDI File (format 1) writer.
+//each track is spooled to its own temporary file as events arrive, so memory usage is constant
+//regardless of how long the recording runs; close() then joins all tracks into the final file.
+struct MIDI {
+  static constexpr u32 Tracks = 16;
+
+  ~MIDI() { close(); }
+
+  explicit operator bool() const { return _tracks > 0; }
+
+  auto open(const string& filename, u32 tracks, u32 division = 960) -> bool {
+    close();
+    if(tracks == 0 || tracks > Tracks) return false;
+    _filename = filename;
+    _division = division;
+    for(u32 n : range(tracks)) {
+      _track[n].tick = 0;
+      if(!_track[n].fp.open(spool(n), file::mode::write)) {
+        for(u32 m : range(n)) _track[m].fp.close(), file::remove(spool(m));
+        return false;
+      }
+    }
+    _tracks = tracks;
+    return true;
+  }
+
+  //sequence/track name meta event
+  auto name(u32 track, const string& text) -> void {
+    meta(track, _track[track].tick, 0x03, text);
+  }
+
+  //set tempo meta event (tempo changes belong in the first track of a format 1 file)
+  auto tempo(u64 tick, u32 microsecondsPerQuarterNote) -> void {
+    string data;
+    data.append((char)(microsecondsPerQuarterNote >> 16));
+    data.append((char)(microsecondsPerQuarterNote >>  8));
+    data.append((char)(microsecondsPerQuarterNote >>  0));
+    meta(0, tick, 0x51, data);
+  }
+
+  //writes a channel voice message (status | data1 << 8 | data2 << 16)
+  auto write(u32 track, u64 tick, u32 message) -> void {
+    if(track >= _tracks) return;
+    u8 status = message;
+    if(status < 0x80 || status >= 0xf0) return;
+    auto& fp = _track[track].fp;
+    delta(track, tick);
+    fp.write(status);
+    fp.write(message >> 8 & 0x7f);
+    //program change and channel pressure carry only one data byte
+    if((status & 0xe0) != 0xc0) fp.write(message >> 16 & 0x7f);
+  }
+
+  auto close() -> bool {
+    if(!_tracks) return false;
+
+    file_buffer fp;
+    bool result = fp.open(_filename, file::mode::write);
+    if(result) {
+      fp.writes("MThd");
+      fp.writem(6, 4);
+      fp.writem(1, 2);  //format 1: simultaneous tracks
+      fp.writem(_tracks, 2);
+      fp.writem(_division, 2);
+    }
+
+    for(u32 n : range(_tracks)) {
+      meta(n, _track[n].tick, 0x2f, {});  //end of track
+      _track[n].fp.close();
+      if(result) {
+        file_buffer track{spool(n), file::mode::read};
+        fp.writes("MTrk");
+        fp.writem(track.size(), 4);
+        for(u64 offset : range(track.size())) fp.write(track.read());
+      }
+      file::remove(spool(n));
+    }
+
+    _tracks = 0;
+    return result;
+  }
+
+private:
+  auto spool(u32 track) const -> string {
+    return {_filename, ".", track, ".tmp"};
+  }
+
+  //delta-times are encoded as variable-length quantities; events may never go back in time.
+  auto delta(u32 track, u64 tick) -> void {
+    auto& t = _track[track];
+    u32 delta = tick > t.tick ? min(tick - t.tick, 0x0fff'ffffull) : 0;
+    t.tick += delta;
+    u8 bytes[4];
+    u32 length = 0;
+    do { bytes[length++] = delta & 0x7f; delta >>= 7; } while(delta);
+    while(length--) t.fp.write(bytes[length] | (length ? 0x80 : 0x00));
+  }
+
+  auto meta(u32 track, u64 tick, u8 type, const string& data) -> void {
+    if(track >= _tracks) return;
+    delta(track, tick);
+    auto& fp = _track[track].fp;
+    fp.write(0xff);
+    fp.write(type);
+    fp.write(data.size());  //all meta events written here are shorter than 128 bytes
+    for(auto byte : data) fp.write(byte);
+  }
+
+  struct Track {
+    file_buffer fp;
+    u64 tick = 0;
+  };
+
+  string _filename;
+  u32 _division = 960;
+  u32 _tracks = 0;
+  Track _track[Tracks];
+};
+
+}
@@ -23,4 +23,12 @@ namespace nall {
 namespace nall {
   template<uint Bits> auto Natural<Bits>::integer() const -> Integer<Bits> { return Integer<Bits>(*this); }
   template<uint Bits> auto Integer<Bits>::natural() const -> Natural<Bits> { return Natural<Bits>(*this); }
+
+  //Natural and Integer serialize their underlying value, which is all they hold:
+  template<uint Bits> struct serializer_bulk<Natural<Bits>> {
+    static constexpr bool value = sizeof(Natural<Bits>) == sizeof(typename Natural<Bits>::utype);
+  };
+  template<uint Bits> struct serializer_bulk<Integer<Bits>> {
+    static constexpr bool value = sizeof(Integer<Bits>) == sizeof(typename Integer<Bits>::stype);
+  };
 }
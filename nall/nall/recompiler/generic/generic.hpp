@@ -12,8 +12,10 @@ namespace nall::recompiler {
     generic(bump_allocator& alloc) : allocator(alloc) {}
     ~generic() { resetCompiler(); }
 
-    auto beginFunction(int args) -> void {
+    //cached is the number of host registers to reserve for cacheBind()
+    auto beginFunction(int args, int cached = 0) -> void {
       assert(args <= 3);
+      assert(cached <= cacheCapacity);
       resetCompiler();
       compiler = sljit_create_compiler(nullptr);
 
@@ -21,7 +23,8 @@ namespace nall::recompiler {
       if(args >= 1) options |= SLJIT_ARG_VALUE(SLJIT_ARG_TYPE_W, 1);
       if(args >= 2) options |= SLJIT_ARG_VALUE(SLJIT_ARG_TYPE_W, 2);
       if(args >= 3) options |= SLJIT_ARG_VALUE(SLJIT_ARG_TYPE_W, 3);
-      sljit_emit_enter(compiler, 0, options, 4, 3, 0);
+      sljit_emit_enter(compiler, 0, options, 4, 3 + cached, 0);
+      cacheSize = 0;
       sljit_jump* entry = sljit_emit_jump(compiler, SLJIT_JUMP);
       epilogue = sljit_emit_label(compiler);
       sljit_emit_return_void(compiler);
@@ -30,9 +33,16 @@ namespace nall::recompiler {
     }
 
     auto endFunction() -> u8* {
+      u8* code = generateFunction();
+      resetCompiler();
+      return code;
+    }
+
+    //as endFunction(), but keeps the compiler so that label and jump addresses can still be read.
+    //resetCompiler() must be called afterward.
+    auto generateFunction() -> u8* {
       u8* code = (u8*)sljit_generate_code(compiler, 0, &allocator);
       allocator.reserve(sljit_get_generated_code_size(compiler));
-      resetCompiler();
       return code;
     }
 
@@ -65,6 +75,7 @@ namespace nall::recompiler {
     #include "constants.hpp"
     #include "encoder-instructions.hpp"
     #include "encoder-calls.hpp"
+    #include "register-cache.hpp"
   };
 }
 #endif
@@ -0,0 +1,86 @@
+#pragma once
+
+//{
+  //keeps guest registers in host saved registers for the length of a function.
+  //each bound guest register (a memory operand) is loaded the first time it is read,
+  //and stored back only by cacheFlush() or cacheStore(); cacheForget() drops the loaded values.
+  //the state is tracked as code is emitted, so any code that branches around a cacheRead()
+  //or cacheWrite() must leave the cache in the same state on every path.
+
+  static constexpr u32 cacheCapacity = SLJIT_NUMBER_OF_SAVED_REGISTERS - 3 < 8 ? SLJIT_NUMBER_OF_SAVED_REGISTERS - 3 : 8;
+
+  struct cache_entry {
+    op_base guest{0, 0};
+    bool loaded = false;
+    bool dirty = false;
+  };
+
+  cache_entry cacheEntries[cacheCapacity];
+  u32 cacheSize = 0;
+
+  //the host register of entry n; S0-S2 hold the function arguments
+  static auto cacheHost(u32 n) -> sreg {
+    return sreg(3 + n);
+  }
+
+  auto cacheFind(mem guest) -> maybe<u32> {
+    for(u32 n : range(cacheSize)) {
+      if(cacheEntries[n].guest.fst == guest.fst && cacheEntries[n].guest.snd == guest.snd) return n;
+    }
+    return nothing;
+  }
+
+  //binds a guest register to the next free host register; must precede any use of it
+  auto cacheBind(mem guest) -> bool {
+    if(cacheSize >= cacheCapacity || cacheFind(guest)) return false;
+    cacheEntries[cacheSize++] = {guest, false, false};
+    return true;
+  }
+
+  //returns the operand to read a guest register from
+  auto cacheRead(mem guest) -> op_base {
+    auto n = cacheFind(guest);
+    if(!n) return guest;
+    auto& entry = cacheEntries[*n];
+    if(!entry.loaded) mov64(cacheHost(*n), guest);
+    entry.loaded = true;
+    return cacheHost(*n);
+  }
+
+  //returns the operand to write a whole guest register to.
+  //the register must not also be read by the same instruction afterward: call cacheRead() first.
+  auto cacheWrite(mem guest) -> op_base {
+    auto n = cacheFind(guest);
+    if(!n) return guest;
+    auto& entry = cacheEntries[*n];
+    entry.loaded = true;
+    entry.dirty = true;
+    return cacheHost(*n);
+  }
+
+  //a bit for each entry that has been written since it was last stored
+  auto cacheDirty() const -> u32 {
+    u32 mask = 0;
+    for(u32 n : range(cacheSize)) {
+      if(cacheEntries[n].dirty) mask |= 1 << n;
+    }
+    return mask;
+  }
+
+  //stores the given entries, without changing the tracked state; used on paths that leave the function
+  auto cacheStore(u32 mask) -> void {
+    for(u32 n : range(cacheSize)) {
+      if(mask >> n & 1) mov64(cacheEntries[n].guest, cacheHost(n));
+    }
+  }
+
+  auto cacheFlush() -> void {
+    cacheStore(cacheDirty());
+    for(u32 n : range(cacheSize)) cacheEntries[n].dirty = false;
+  }
+
+  //the guest registers may have been modified in memory: reload them before their next use
+  auto cacheForget() -> void {
+    for(u32 n : range(cacheSize)) cacheEntries[n].loaded = false;
+  }
+//};
@@ -30,6 +30,13 @@ struct has_serialize {
 };
 template<typename T> constexpr bool has_serialize_v = has_serialize<T>::value;
 
+//types whose serialized form is their in-memory representation on little-endian hosts,
+//so that arrays of them can be copied in bulk. specialized for nall primitives in primitives.hpp.
+template<typename T> struct serializer_bulk {
+  static constexpr bool value = is_integral_v<T> && !is_same_v<T, bool>;
+};
+template<typename T> constexpr bool serializer_bulk_v = serializer_bulk<T>::value;
+
 struct serializer {
   explicit operator bool() const {
     return _size;
@@ -65,6 +72,21 @@ struct serializer {
     return _capacity;
   }
 
+  //a nonzero generation means data() already holds an image of the state as of that generation;
+  //objects that track their own writes may then skip() over the parts that have not changed since.
+  auto generation() const -> u32 {
+    return _generation;
+  }
+
+  auto setGeneration(u32 generation) -> void {
+    _generation = generation;
+  }
+
+  auto skip(u32 size) -> void {
+    reserve(_size + size);
+    _size += size;
+  }
+
   auto reserve(u32 size) -> void {
     if(size > _capacity) {
       auto data = new u8[bit::round(size)]();
@@ -88,11 +110,17 @@ struct serializer {
   }
 
   template<typename T, s32 N> auto operator()(T (&array)[N]) -> serializer& {
+    #if defined(ENDIAN_LITTLE)
+    if constexpr(serializer_bulk_v<T>) return bulk(array, N * sizeof(T));
+    #endif
     for(auto& value : array) operator()(value);
     return *this;
   }
 
   template<typename T> auto operator()(array_span<T> array) -> serializer& {
+    #if defined(ENDIAN_LITTLE)
+    if constexpr(serializer_bulk_v<T>) return bulk(array.data(), array.size() * sizeof(T));
+    #endif
     for(auto& value : array) operator()(value);
     return *this;
   }
@@ -105,6 +133,7 @@ struct serializer {
     _data = new u8[s._capacity];
     _size = s._size;
     _capacity = s._capacity;
+    _generation = s._generation;
 
     memory::copy(_data, s._data, s._capacity);
     return *this;
@@ -118,6 +147,7 @@ struct serializer {
     _data = s._data;
     _size = s._size;
     _capacity = s._capacity;
+    _generation = s._generation;
 
     s._data = nullptr;
     return *this;
@@ -146,6 +176,17 @@ struct serializer {
   }
 
 private:
+  auto bulk(void* data, u32 size) -> serializer& {
+    reserve(_size + size);
+    if(writing()) {
+      memory::copy(_data + _size, data, size);
+    } else if(reading()) {
+      memory::copy(data, _data + _size, size);
+    }
+    _size += size;
+    return *this;
+  }
+
   template<typename T> auto integer(T& value) -> serializer& {
     enum : u32 { size = std::is_same<bool, T>::value ? 1 : sizeof(T) };
     reserve(_size + size);
@@ -176,6 +217,7 @@ private:
   u8* _data = nullptr;
   u32 _size = 0;
   u32 _capacity = 0;
+  u32 _generation = 0;
 };
 
 }
@@ -0,0 +1,125 @@
+#include <alsa/asoundlib.h>
+
+//ALSA sequencer MIDI output.
+//ares registers itself as a sequencer client with one output port. selecting "Virtual Port" leaves that port
+//unconnected for other applications (synthesizers, DAWs) to subscribe to; selecting a listed port connects to it.
+//each batch of messages is scheduled on a sequencer queue and submitted with a single drain, so the kernel
+//takes care of delivering every message at its due time.
+
+namespace MIDI {
+
+static constexpr bool Scheduled = true;
+
+snd_seq_t* sequencer = nullptr;
+s32 port = -1;
+s32 queue = -1;
+
+auto devices() -> vector<string> {
+  vector<string> devices{"None", "Virtual Port"};
+
+  snd_seq_t* handle = sequencer;
+  if(!handle && snd_seq_open(&handle, "default", SND_SEQ_OPEN_OUTPUT, SND_SEQ_NONBLOCK) < 0) return devices;
+
+  snd_seq_client_info_t* clientInfo;
+  snd_seq_port_info_t* portInfo;
+  snd_seq_client_info_alloca(&clientInfo);
+  snd_seq_port_info_alloca(&portInfo);
+
+  snd_seq_client_info_set_client(clientInfo, -1);
+  while(snd_seq_query_next_client(handle, clientInfo) >= 0) {
+    s32 client = snd_seq_client_info_get_client(clientInfo);
+    if(client == SND_SEQ_CLIENT_SYSTEM || client == snd_seq_client_id(handle)) continue;
+
+    snd_seq_port_info_set_client(portInfo, client);
+    snd_seq_port_info_set_port(portInfo, -1);
+    while(snd_seq_query_next_port(handle, portInfo) >= 0) {
+      u32 capability = snd_seq_port_info_get_capability(portInfo);
+      if((capability & SND_SEQ_PORT_CAP_WRITE) == 0) continue;
+      if((capability & SND_SEQ_PORT_CAP_SUBS_WRITE) == 0) continue;
+      if(capability & SND_SEQ_PORT_CAP_NO_EXPORT) continue;
+      devices.append({client, ":", snd_seq_port_info_get_port(portInfo), " ", snd_seq_port_info_get_name(portInfo)});
+    }
+  }
+
+  if(handle != sequencer) snd_seq_close(handle);
+  return devices;
+}
+
+auto close() -> void {
+  if(!sequencer) return;
+  snd_seq_drain_output(sequencer);
+  if(queue >= 0) snd_seq_free_queue(sequencer, queue);
+  snd_seq_close(sequencer);
+  sequencer = nullptr;
+  port = -1;
+  queue = -1;
+}
+
+auto open(const string& device) -> bool {
+  close();
+  if(device == "None") return true;
+
+  if(snd_seq_open(&sequencer, "default", SND_SEQ_OPEN_OUTPUT, SND_SEQ_NONBLOCK) < 0) {
+    sequencer = nullptr;
+    return false;
+  }
+  snd_seq_set_client_name(sequencer, "ares");
+
+  port = snd_seq_create_simple_port(sequencer, "MIDI Out",
+    SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ,
+    SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION
+  );
+  queue = snd_seq_alloc_named_queue(sequencer, "ares");
+  if(port < 0 || queue < 0) return close(), false;
+  snd_seq_start_queue(sequencer, queue, nullptr);
+  snd_seq_drain_output(sequencer);
+
+  if(device != "Virtual Port") {
+    //devices are listed as "client:port name"
+    auto address = device.split(" ", 1L).first().split(":");
+    if(address.size() != 2) return close(), false;
+    if(snd_seq_connect_to(sequencer, port, address[0].integer(), address[1].integer()) < 0) return close(), false;
+  }
+
+  return true;
+}
+
+//queues a message to be delivered delay microseconds from now; nothing reaches the kernel until flush().
+auto write(u32 delay, u32 message) -> void {
+  if(!sequencer) return;
+
+  u8 status = message >> 0;
+  u8 channel = status & 0x0f;
+  u8 data1 = message >> 8 & 0x7f;
+  u8 data2 = message >> 16 & 0x7f;
+
+  snd_seq_event_t event;
+  snd_seq_ev_clear(&event);
+  switch(status & 0xf0) {
+  case 0x80: snd_seq_ev_set_noteoff(&event, channel, data1, data2); break;
+  case 0x90: snd_seq_ev_set_noteon(&event, channel, data1, data2); break;
+  case 0xa0: snd_seq_ev_set_keypress(&event, channel, data1, data2); break;
+  case 0xb0: snd_seq_ev_set_controller(&event, channel, data1, data2); break;
+  case 0xc0: snd_seq_ev_set_pgmchange(&event, channel, data1); break;
+  case 0xd0: snd_seq_ev_set_chanpress(&event, channel, data1); break;
+  case 0xe0: snd_seq_ev_set_pitchbend(&event, channel, (data2 << 7 | data1) - 8192); break;
+  default: return;
+  }
+  snd_seq_ev_set_source(&event, port);
+  snd_seq_ev_set_subs(&event);
+
+  snd_seq_real_time_t time;
+  time.tv_sec = delay / 1'000'000;
+  time.tv_nsec = delay % 1'000'000 * 1'000;
+  snd_seq_ev_schedule_real(&event, queue, 1, &time);
+
+  //if the output buffer is full (the sequencer is not keeping up), the message is dropped rather than blocking
+  snd_seq_event_output(sequencer, &event);
+}
+
+auto flush() -> void {
+  if(!sequencer) return;
+  snd_seq_drain_output(sequencer);
+}
+
+}
@@ -55,16 +55,25 @@
 #include <ruby/audio/sdl.cpp>
 #endif
 
-#if defined(MIDI_PORTMIDI)
+#if defined(MIDI_ALSA)
+  #include <ruby/audio/alsa-midi.cpp>
+#elif defined(MIDI_PORTMIDI)
   #include <ruby/audio/portmidi.cpp>
 #else
 namespace MIDI {
-auto writeShort(s32 msg) -> void {}
+static constexpr bool Scheduled = true;
+auto devices() -> vector<string> { return {"None"}; }
+auto open(const string& device) -> bool { return device == "None"; }
+auto close() -> void {}
+auto write(u32 delay, u32 message) -> void {}
+auto flush() -> void {}
 }
 #endif
 
 namespace ruby {
 
+#include <ruby/audio/midi.cpp>
+
 auto Audio::setExclusive(bool exclusive) -> bool {
   if(instance->exclusive == exclusive) return true;
   if(!instance->hasExclusive()) return false;
@@ -86,6 +95,13 @@ auto Audio::setDevice(string device) -> bool {
   return true;
 }
 
+auto Audio::setMIDIDevice(string device) -> bool {
+  if(midiOutput.device() == device) return true;
+  if(!hasMIDIDevice(device)) return false;
+  if(!midiOutput.create(device)) return midiOutput.create("None"), false;
+  return true;
+}
+
 auto Audio::setBlocking(bool blocking) -> bool {
   if(instance->blocking == blocking) return true;
   if(!instance->hasBlocking()) return false;
@@ -167,15 +183,20 @@ auto Audio::output(const f64 samples[]) -> void {
   }
 }
 
-auto Audio::midiShort(s32 msg) -> void {
-  MIDI::writeShort(msg);
+auto Audio::midi(const MIDIEvent events[], u32 count) -> void {
+  midiOutput.write(events, count);
 }
 
 
 //
 
 auto Audio::create(string driver) -> bool {
-  MIDI::init();
+  //MIDI output does not depend on the audio driver: keep the current device open across driver changes
+  if(!midiOutput.device()) {
+    auto devices = hasMIDIDevices();
+    //prefer the first real device over "None"
+    midiOutput.create(devices(1, devices.first()));
+  }
 
   self.instance.reset();
   if(!driver) driver = optimalDriver();
@@ -51,6 +51,40 @@ protected:
   u32 latency = 0;
 };
 
+struct MIDIEvent {
+  u32 offset;  //microseconds from the start of the batch
+  u32 message;
+};
+
+//asynchronous MIDI output queue:
+//batches of messages are timestamped and queued by the emulation thread, and delivered to the MIDI device once
+//they are due, so device I/O can never stall emulation. drivers that can schedule messages themselves are handed
+//each batch directly; otherwise a dedicated output thread waits for each message to fall due.
+struct MIDIOutput {
+  struct Event {
+    u64 timestamp;  //chrono::microsecond() at which the message is due
+    u32 message;
+  };
+
+  ~MIDIOutput() { destroy(); }
+
+  static auto devices() -> vector<string>;
+  auto device() const -> string { return _device; }
+
+  auto create(const string& device) -> bool;
+  auto destroy() -> void;
+  auto write(const MIDIEvent events[], u32 count) -> void;
+
+private:
+  auto main(uintptr) -> void;
+
+  nall::thread handle;
+  nall::queue_spsc<Event[8192]> fifo;
+  atomic<bool> running = false;
+  u64 schedule = 0;  //earliest time at which the next message may be delivered
+  string _device;
+};
+
 struct Audio {
   static auto hasDrivers() -> vector<string>;
   static auto hasDriver(string driver) -> bool { return (bool)hasDrivers().find(driver); }
@@ -77,6 +111,8 @@ struct Audio {
   auto hasChannels(u32 channels) -> bool { return instance->hasChannels(channels); }
   auto hasFrequency(u32 frequency) -> bool { return instance->hasFrequency(frequency); }
   auto hasLatency(u32 latency) -> bool { return instance->hasLatency(latency); }
+  auto hasMIDIDevices() -> vector<string> { return MIDIOutput::devices(); }
+  auto hasMIDIDevice(string device) -> bool { return (bool)hasMIDIDevices().find(device); }
 
   auto exclusive() -> bool { return instance->exclusive; }
   auto context() -> uintptr { return instance->context; }
@@ -86,6 +122,7 @@ struct Audio {
   auto channels() -> u32 { return instance->channels; }
   auto frequency() -> u32 { return instance->frequency; }
   auto latency() -> u32 { return instance->latency; }
+  auto midiDevice() -> string { return midiOutput.device(); }
 
   auto setExclusive(bool exclusive) -> bool;
   auto setContext(uintptr context) -> bool;
@@ -95,6 +132,7 @@ struct Audio {
   auto setChannels(u32 channels) -> bool;
   auto setFrequency(u32 frequency) -> bool;
   auto setLatency(u32 latency) -> bool;
+  auto setMIDIDevice(string device) -> bool;
 
   auto updateResampleChannels(u32 channels) -> void;
   auto updateResampleFrequency(u32 frequency) -> void;
@@ -103,11 +141,12 @@ struct Audio {
   auto level() -> double;
   auto output(const f64 samples[]) -> void;
 
-  auto midiShort(s32 msg) -> void;
+  auto midi(const MIDIEvent events[], u32 count) -> void;
 
 protected:
   Audio& self;
   unique_pointer<AudioDriver> instance;
   vector<nall::DSP::Resampler::Cubic> resamplers;
   vector<f64> resampleBuffer;
+  MIDIOutput midiOutput;
 };
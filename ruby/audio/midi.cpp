@@ -0,0 +1,58 @@
+auto MIDIOutput::devices() -> vector<string> {
+  return MIDI::devices();
+}
+
+auto MIDIOutput::create(const string& device) -> bool {
+  destroy();
+  if(!MIDI::open(device)) return false;
+  _device = device;
+  fifo.flush();
+  schedule = 0;
+  running = true;
+  if(!MIDI::Scheduled) handle = nall::thread::create({&MIDIOutput::main, this});
+  return true;
+}
+
+auto MIDIOutput::destroy() -> void {
+  if(!running) return;
+  running = false;
+  if(!MIDI::Scheduled) handle.join();
+  MIDI::close();
+  _device = {};
+}
+
+//called from the emulation thread once per frame: never blocks.
+//the batch is played back starting now, preserving the spacing between its events.
+//if the output has fallen so far behind that the queue is full, messages are dropped.
+auto MIDIOutput::write(const MIDIEvent events[], u32 count) -> void {
+  if(!running) return;
+  u64 base = chrono::microsecond();
+  for(u32 n : range(count)) {
+    //never reorder messages, even if the previous batch is still being played back:
+    schedule = max(schedule, base + events[n].offset);
+    if(MIDI::Scheduled) MIDI::write(schedule - base, events[n].message);
+    else fifo.write({schedule, events[n].message});
+  }
+  if(MIDI::Scheduled) MIDI::flush();
+}
+
+auto MIDIOutput::main(uintptr) -> void {
+  while(running) {
+    auto event = fifo.read();
+    if(!event) {
+      usleep(1000);
+      continue;
+    }
+
+    //sleep until shortly before the message is due, then spin for the remainder to keep timing tight.
+    while(running) {
+      u64 now = chrono::microsecond();
+      if(now >= event->timestamp) break;
+      if(event->timestamp - now > 1000) usleep(500);
+      else spinloop();
+    }
+
+    MIDI::write(0, event->message);
+    MIDI::flush();
+  }
+}
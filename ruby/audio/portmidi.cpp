@@ -5,120 +5,73 @@ extern "C" {
 
 namespace MIDI {
 
-PortMidiStream* stream = nullptr;
-
-auto init() -> void {
-  static bool inited = false;
-
-  PmError err;
-
-  if (inited) {
-    Pm_Terminate();
-    inited = false;
-  }
+//messages are written immediately, so MIDIOutput delivers them from its own thread at their due times.
+static constexpr bool Scheduled = false;
 
-  err = Pm_Initialize();
-  if (err != pmNoError) {
-    NSLog(@"portmidi: Pm_Initialize(): %s", Pm_GetErrorText(err));
-    return;
-  }
-  NSLog(@"portmidi: Pm_Initialize()");
-
-  int devCount = Pm_CountDevices();
-  for (int i = 0; i < devCount; i++) {
-    auto d = Pm_GetDeviceInfo(i);
-    NSLog(@"portmidi: [%d]: in=%d, out=%d, interf='%s', name='%s'",
-      i,
-      d->input,
-      d->output,
-      d->interf,
-      d->name
-    );
-  }
-
-  // prefer USB Midi:
-  PmDeviceID devOut = pmNoDevice;
-  for (int i = 0; i < devCount; i++) {
-    auto d = Pm_GetDeviceInfo(i);
-    if (d->output) {
-      if (strncmp("USB Midi", d->name, 8) == 0) {
-        devOut = i;
-      }
-    }
-  }
+PortMidiStream* stream = nullptr;
 
-  // fallback to IAC:
-  if (devOut == pmNoDevice) {
-    for (int i = 0; i < devCount; i++) {
-      auto d = Pm_GetDeviceInfo(i);
-      if (d->output) {
-        if (strncmp("IAC Driver Bus 1", d->name, 16) == 0) {
-          devOut = i;
-        }
-      }
-    }
+auto initialize() -> bool {
+  static bool initialized = false;
+  if(initialized) return true;
+  if(auto error = Pm_Initialize(); error != pmNoError) {
+    print("portmidi: Pm_Initialize(): ", Pm_GetErrorText(error), "\n");
+    return false;
   }
+  return initialized = true;
+}
 
-  //PmDeviceID devOut = Pm_GetDefaultOutputDeviceID();
-
-  err = Pm_OpenOutput(
-    &stream,
-    devOut,
-    nullptr, // void *outputDriverInfo
-    2000,    // bufferSize
-    nullptr, // time_proc
-    nullptr, // time_info
-    0        // latency
-  );
-  if (err != pmNoError) {
-    NSLog(@"portmidi: Pm_OpenOutput(%d): %s", devOut, Pm_GetErrorText(err));
-    return;
+auto devices() -> vector<string> {
+  vector<string> devices{"None"};
+  if(!initialize()) return devices;
+  for(u32 id : range(Pm_CountDevices())) {
+    auto info = Pm_GetDeviceInfo(id);
+    if(info && info->output) devices.append(info->name);
   }
+  return devices;
+}
 
-  NSLog(@"portmidi: Pm_OpenOutput(%d)", devOut);
-
-  inited = true;
+auto close() -> void {
+  if(!stream) return;
+  Pm_Close(stream);
+  stream = nullptr;
 }
 
-auto writeShort(s32 msg) -> void {
-  static PtTimestamp lastTs = 0;
-  const char *spaces = "                                                                                                                ";
+auto open(const string& device) -> bool {
+  close();
+  if(device == "None") return true;
+  if(!initialize()) return false;
 
-  if (!stream) {
-    return;
+  PmDeviceID id = pmNoDevice;
+  for(u32 n : range(Pm_CountDevices())) {
+    auto info = Pm_GetDeviceInfo(n);
+    if(info && info->output && device == info->name) id = n;
   }
+  if(id == pmNoDevice) return false;
 
-  PmError err;
-  int retry = 100;
-
-  PtTimestamp ts;
-  if (msg == 0xFFFFFFFF) {
-//    NSLog(@"midi: delay");
-    PtTimestamp lastTs = Pt_Time();
-    do {
-      ts = Pt_Time();
-    } while ((ts - lastTs) <= 2);
-    lastTs = ts;
-    return;
+  if(auto error = Pm_OpenOutput(&stream, id, nullptr, 2000, nullptr, nullptr, 0); error != pmNoError) {
+    print("portmidi: Pm_OpenOutput(", device, "): ", Pm_GetErrorText(error), "\n");
+    stream = nullptr;
+    return false;
   }
+  return true;
+}
 
-  ts = Pt_Time();
-
-//  NSLog(@"[%9u] %.*s%02X%02X%02X", ts, (msg&0x0F) * 7, spaces, msg&0xFF, (msg>>8)&0xFF, (msg>>16)&0xFF);
+//called from the MIDIOutput thread: messages arrive here already spaced out at their scheduled times.
+auto write(u32 delay, u32 message) -> void {
+  if(!stream) return;
 
+  PmError error;
+  u32 retries = 100;
   do {
-    err = Pm_WriteShort(stream, 0, msg);
-    if (err != pmNoError) {
-      NSLog(@"portmidi: Pm_WriteShort err=%d: '%s'", err, Pm_GetErrorText(err));
-    }
-    if (retry-- <= 0) break;
-  } while (err != pmNoError);
+    error = Pm_WriteShort(stream, 0, message);
+  } while(error != pmNoError && retries--);
 
-  if (err != pmNoError) {
-    NSLog(@"portmidi: Pm_WriteShort err=%d: '%s'; no more retries", err, Pm_GetErrorText(err));
+  if(error != pmNoError) {
+    print("portmidi: Pm_WriteShort(): ", Pm_GetErrorText(error), "\n");
   }
+}
 
-  lastTs = ts;
+auto flush() -> void {
 }
 
 }
@@ -9,6 +9,7 @@ target_sources(
   PRIVATE #
     audio/oss.cpp
     audio/alsa.cpp
+    audio/alsa-midi.cpp
     audio/openal.cpp
     audio/sdl.cpp
     audio/pulseaudio.cpp
@@ -83,8 +84,10 @@ if(ARES_ENABLE_ALSA)
 endif()
 if(ALSA_FOUND)
   target_enable_feature(ruby "ALSA audio driver" AUDIO_ALSA)
+  target_enable_feature(ruby "ALSA sequencer MIDI driver" MIDI_ALSA)
 else()
   target_disable_feature(ruby "ALSA audio driver")
+  target_disable_feature(ruby "ALSA sequencer MIDI driver")
 endif()
 
 option(ARES_ENABLE_PULSEAUDIO "Enable the Pulse audio driver" ON)
@@ -0,0 +1,148 @@
+#include <nall/nall.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <ares/ares.hpp>
+
+//checks the vectorized filter kernels used by Stream::flush() against running each stage one sample at a time.
+//cascades of every length up to 20 stages, which covers every kernel width and the splitting of longer cascades,
+//filter blocks of every length from 1 to Stream::BlockSize, followed by random lengths, carrying state between blocks.
+//the kernels match the scalar path exactly unless the compiler fuses multiply-adds differently in each,
+//so samples are compared against a tolerance, and the number that match exactly is reported.
+//eg: audio-kernel --blocks 1000
+
+#if defined(ARCHITECTURE_AMD64)
+  #include <immintrin.h>
+  #define ARES_AUDIO_SSE2
+#elif defined(ARCHITECTURE_ARM64) && !defined(COMPILER_MICROSOFT)
+  #define SSE2NEON_SUPPRESS_WARNINGS
+  #include <sse2neon.h>
+  #define ARES_AUDIO_SSE2
+#endif
+
+namespace ares::Core::Audio::Test {
+  #include <ares/node/audio/kernel.cpp>
+}
+
+using Stage = ares::Core::Audio::Stream::Stage;
+namespace Kernel = ares::Core::Audio::Test::Kernel;
+
+static constexpr u32 MaximumStages = 20;
+static constexpr u32 BlockSize = ares::Core::Audio::Stream::BlockSize;
+static constexpr f64 Tolerance = 1e-9;
+
+struct Random {
+  auto operator()() -> f64 {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return (seed >> 11) * (1.0 / 9007199254740992.0);
+  }
+  u64 seed = 1;
+};
+
+static auto scientific(f64 value) -> string {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.2e", value);
+  return buffer;
+}
+
+//a mix of one-pole and second-order filters, with the cutoffs the cores use and beyond
+static auto stages(Random& random, u32 count) -> vector<Stage> {
+  vector<Stage> stages;
+  for(u32 n : range(count)) {
+    f64 frequency = 1'789'772.0;
+    if(random() < 0.4) {
+      DSP::IIR::OnePole filter;
+      auto type = random() < 0.5 ? DSP::IIR::OnePole::Type::LowPass : DSP::IIR::OnePole::Type::HighPass;
+      filter.reset(type, 50.0 + random() * 10'000.0, frequency);
+      auto c = filter.coefficients();
+      stages.append({c.a0, 0.0, 0.0, -c.b1, 0.0});
+    } else {
+      DSP::IIR::Biquad filter;
+      filter.reset(DSP::IIR::Biquad::Type::LowPass, 1'000.0 + random() * 20'000.0, frequency, DSP::IIR::Biquad::butterworth(6, n % 3));
+      auto c = filter.coefficients();
+      stages.append({c.a0, c.a1, c.a2, c.b1, c.b2});
+    }
+  }
+  return stages;
+}
+
+struct Result {
+  u64 samples = 0;
+  u64 exact = 0;
+  u64 failures = 0;
+  f64 error = 0.0;
+
+  auto compare(f64 sample, f64 expected) -> void {
+    samples++;
+    if(memory::compare(&sample, &expected, sizeof(f64)) == 0) { exact++; return; }
+    f64 difference = abs(sample - expected);
+    error = max(error, difference);
+    if(!(difference <= Tolerance)) failures++;
+  }
+
+  auto compare(const vector<Stage>& stages, const vector<Stage>& expected) -> void {
+    for(u32 n : range(stages.size())) {
+      compare(stages[n].z1, expected[n].z1);
+      compare(stages[n].z2, expected[n].z2);
+    }
+  }
+};
+
+//runs one channel, or two with different filters and input, through blocks of the given lengths
+static auto test(Random& random, u32 count, bool paired, const vector<u32>& lengths) -> Result {
+  Result result;
+  auto left = stages(random, count), right = stages(random, count);
+  auto leftExpected = left, rightExpected = right;
+  f64 leftSamples[BlockSize], rightSamples[BlockSize];
+  f64 leftReference[BlockSize], rightReference[BlockSize];
+
+  for(u32 length : lengths) {
+    for(u32 n : range(length)) {
+      leftSamples[n] = leftReference[n] = random() * 2.0 - 1.0 + 1e-25;
+      rightSamples[n] = rightReference[n] = random() * 2.0 - 1.0 + 1e-25;
+    }
+    Kernel::cascade(leftExpected.data(), count, leftReference, length);
+    if(paired) {
+      Kernel::cascade(rightExpected.data(), count, rightReference, length);
+      Kernel::filter(left.data(), right.data(), count, leftSamples, rightSamples, length);
+    } else {
+      Kernel::filter(left.data(), count, leftSamples, length);
+    }
+    for(u32 n : range(length)) {
+      result.compare(leftSamples[n], leftReference[n]);
+      if(paired) result.compare(rightSamples[n], rightReference[n]);
+    }
+  }
+
+  result.compare(left, leftExpected);
+  if(paired) result.compare(right, rightExpected);
+  return result;
+}
+
+auto nall::main(Arguments arguments) -> void {
+  u32 blocks = 500;
+  if(string value; arguments.take("--blocks", value)) blocks = value.natural();
+
+  Random random;
+  vector<u32> lengths;
+  for(u32 length : range(1, BlockSize + 1)) lengths.append(length);
+  for(u32 block : range(blocks)) lengths.append(1 + u32(random() * BlockSize) % BlockSize);
+
+  u64 failures = 0;
+  print("stages  mode    samples    exact      max error\n");
+  for(u32 count : range(MaximumStages + 1)) {
+    for(bool paired : {false, true}) {
+      auto result = test(random, count, paired, lengths);
+      print(pad(count, 6), "  ", paired ? "paired" : "mono  ", "  ",
+        pad(result.samples, 9), "  ", pad(result.exact, 9), "  ", scientific(result.error), "\n");
+      failures += result.failures;
+    }
+  }
+
+  if(failures) {
+    print("FAIL: ", failures, " samples differ from the scalar filters by more than ", scientific(Tolerance), "\n");
+    exit(EXIT_FAILURE);
+  }
+  print("PASS\n");
+}
@@ -0,0 +1,173 @@
+#include <nall/nall.hpp>
+#include <nall/chrono.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <fc/fc.hpp>
+
+//checks that the Famicom APU, which runs behind the CPU until it could next raise an IRQ or request a DMC DMA
+//(see Thread::setDeadline()), behaves exactly as it does when it is kept in step with the CPU on every cycle.
+//a test program runs on the CPU and APU alone, with frame and DMC IRQs, DMC DMA, $4015 polling and pulse writes,
+//once with Scheduler::setLazy(false) and once with it enabled.
+//the RAM contents, CPU registers and MIDI output, which record when each IRQ, DMA and register access happened,
+//must be identical.
+//eg: fc-apu --frames 600
+
+namespace Famicom = ares::Famicom;
+using Famicom::apu;
+using Famicom::cpu;
+using Famicom::cartridge;
+using Famicom::scheduler;
+using MIDIEvent = ares::Core::Audio::MIDI::Event;
+
+//NTSC: 341 * 262 - 0.5 PPU dots per frame, three dots per CPU cycle
+static constexpr u32 FrameCycles = 29781;
+
+//$8000: reset
+static const u8 Reset[] = {
+  0x78,              //      sei
+  0xa2, 0xff,        //      ldx #$ff
+  0x9a,              //      txs
+  0xa9, 0x00,        //      lda #$00
+  0x8d, 0x17, 0x40,  //      sta $4017  ;4-step sequence, frame IRQ enabled
+  0xa9, 0x8f,        //      lda #$8f
+  0x8d, 0x10, 0x40,  //      sta $4010  ;DMC IRQ enabled, fastest rate
+  0xa9, 0x00,        //      lda #$00
+  0x8d, 0x12, 0x40,  //      sta $4012  ;sample at $c000
+  0xa9, 0x01,        //      lda #$01
+  0x8d, 0x13, 0x40,  //      sta $4013  ;17 bytes long
+  0xa9, 0xbf,        //      lda #$bf
+  0x8d, 0x00, 0x40,  //      sta $4000  ;pulse 1: constant volume
+  0xa9, 0x1f,        //      lda #$1f
+  0x8d, 0x15, 0x40,  //      sta $4015  ;enable every channel, and start the sample
+  0x58,              //      cli
+  0xad, 0x15, 0x40,  //loop: lda $4015
+  0x9d, 0x00, 0x03,  //      sta $0300,x
+  0xe8,              //      inx
+  0xee, 0x03, 0x02,  //      inc $0203
+  0x4c, 0x23, 0x80,  //      jmp loop
+};
+
+//$8100: IRQ
+static const u8 Interrupt[] = {
+  0x48,              //      pha
+  0xad, 0x15, 0x40,  //      lda $4015  ;acknowledges the frame IRQ
+  0x8d, 0x02, 0x02,  //      sta $0202
+  0xee, 0x00, 0x02,  //      inc $0200  ;counts IRQs in $0200-0201
+  0xd0, 0x03,        //      bne +3
+  0xee, 0x01, 0x02,  //      inc $0201
+  0xad, 0x00, 0x02,  //      lda $0200
+  0x8d, 0x02, 0x40,  //      sta $4002  ;pulse 1 period follows the IRQ count
+  0xa9, 0xf9,        //      lda #$f9
+  0x8d, 0x03, 0x40,  //      sta $4003  ;and the note restarts
+  0xa9, 0x1f,        //      lda #$1f
+  0x8d, 0x15, 0x40,  //      sta $4015  ;restarts the sample, which acknowledges the DMC IRQ
+  0x68,              //      pla
+  0x40,              //      rti
+};
+
+struct Board : Famicom::Board::Interface {
+  Board() {
+    memory::copy(programROM, Reset, sizeof(Reset));
+    memory::copy(programROM + 0x100, Interrupt, sizeof(Interrupt));
+    programROM[0x200] = 0x40;  //NMI: rti
+    for(u32 n : range(0x1000)) programROM[0x4000 + n] = n * 37;  //DMC samples
+    programROM[0x7ffa] = 0x00, programROM[0x7ffb] = 0x82;
+    programROM[0x7ffc] = 0x00, programROM[0x7ffd] = 0x80;
+    programROM[0x7ffe] = 0x00, programROM[0x7fff] = 0x81;
+  }
+
+  auto readPRG(n32 address, n8 data) -> n8 override {
+    if(address < 0x8000) return data;
+    return programROM[address & 0x7fff];
+  }
+
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return address & 0x7fff;
+  }
+
+  u8 programROM[0x8000] = {};
+};
+
+struct Harness : ares::Platform {
+  auto midi(ares::Node::Audio::MIDI node) -> void override {
+    for(auto& event : node->events()) events.append(event);
+  }
+
+  vector<MIDIEvent> events;
+};
+
+//ends each frame, as the PPU would
+struct Timer : Famicom::Thread {
+  auto main() -> void {
+    step(FrameCycles * Famicom::cpu.rate());
+    Thread::synchronize(cpu);
+    apu.midiFrame();
+    scheduler.exit(ares::Event::Frame);
+  }
+};
+
+struct Result {
+  f64 seconds;
+  u64 hash;    //FNV-64a of the RAM, CPU registers and MIDI output
+  u32 irqs;
+  u32 events;
+};
+
+static auto run(Harness& harness, u32 frames, bool lazy) -> Result {
+  harness.events.reset();
+  Timer timer;
+  auto root = ares::Node::Object::create();
+  scheduler.reset();
+  scheduler.setLazy(lazy);
+  cpu.load(root);
+  apu.load(root);
+  cpu.power(false);
+  apu.power(false);
+  timer.create(Famicom::system.frequency(), {&Timer::main, &timer});
+  scheduler.power(cpu);
+
+  u64 start = chrono::nanosecond();
+  for(u32 frame : range(frames)) scheduler.enter();
+  f64 seconds = max(1ull, chrono::nanosecond() - start) / 1'000'000'000.0;
+  apu.unload();  //flushes the last MIDI events
+
+  u64 hash = 14695981039346656037ull;
+  auto fold = [&](u64 value) { hash = (hash ^ value) * 1099511628211ull; };
+  for(u32 address : range(0x800)) fold(cpu.ram[address]);
+  for(u64 value : {(u64)cpu.A, (u64)cpu.X, (u64)cpu.Y, (u64)cpu.S, (u64)cpu.PC, (u64)(u8)cpu.P}) fold(value);
+  for(auto& event : harness.events) fold(event.timestamp), fold(event.track), fold(event.message);
+  Result result{seconds, hash, cpu.ram[0x200] | cpu.ram[0x201] << 8, harness.events.size()};
+  cpu.unload();
+  timer.destroy();
+  return result;
+}
+
+auto nall::main(Arguments arguments) -> void {
+  u32 frames = 600;
+  if(string value; arguments.take("--frames", value)) frames = max(1u, value.natural());
+
+  Harness harness;
+  ares::platform = &harness;
+  cartridge.board = new Board;
+
+  //the APU's MIDI translation keeps some state from one load to the next, so both compared runs follow the same one:
+  run(harness, frames, false);
+  auto eager = run(harness, frames, false);
+  auto lazy = run(harness, frames, true);
+  print("mode   seconds   IRQs  MIDI events  hash\n");
+  for(auto& [name, result] : {std::pair{"eager", eager}, std::pair{"lazy ", lazy}}) {
+    print(name, "  ", pad(result.seconds, 7L), "  ", pad(result.irqs, 4), "  ", pad(result.events, 11), "  ", hex(result.hash, 16L), "\n");
+  }
+
+  cartridge.board.reset();
+  scheduler.setLazy(true);
+  ares::platform = nullptr;
+
+  if(eager.hash != lazy.hash || !eager.irqs || !eager.events) {
+    print("FAIL: the lazy APU ", eager.hash != lazy.hash ? "diverged from the eager one" : "was not exercised", "\n");
+    exit(EXIT_FAILURE);
+  }
+  print("PASS\n");
+}
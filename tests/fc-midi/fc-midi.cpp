@@ -0,0 +1,210 @@
+#include <nall/nall.hpp>
+#include <nall/chrono.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <fc/fc.hpp>
+
+//replays a log of APU register writes through the Famicom APU and its MIDI translation, with no video or audio output.
+//
+//log format, one entry per line ('#' starts a comment):
+//  <cycle> <address> <data>  register write: CPU cycle since power (decimal), then address and data (hexadecimal)
+//  prg <address> <bytes>     program ROM contents at $8000-ffff (hexadecimal), read by DMC sample fetches
+//
+//DMC samples are translated using dmc.db, which must be in the same directory as the harness.
+//golden files list one event per line: timestamp (in samples), track, then the message (hexadecimal).
+//--update rewrites the golden file from the current output; --scheduler enables the MIDI node's wire scheduler.
+//eg: fc-midi tests/fc-midi/tune.log --golden tests/fc-midi/tune.golden
+
+namespace Famicom = ares::Famicom;
+using Famicom::apu;
+using Famicom::cpu;
+using Famicom::cartridge;
+using MIDIEvent = ares::Core::Audio::MIDI::Event;
+
+//NTSC: 341 * 262 - 0.5 PPU dots per frame, three dots per CPU cycle
+static constexpr u32 FrameCycles = 29781;
+
+struct Write {
+  u64 cycle;
+  n16 address;
+  n8  data;
+};
+
+struct Board : Famicom::Board::Interface {
+  auto readPRG(n32 address, n8 data) -> n8 override {
+    if(address < 0x8000) return data;
+    return programROM[address & 0x7fff];
+  }
+
+  auto mapPRG(n16 address) -> maybe<u32> override {
+    return address & 0x7fff;
+  }
+
+  u8 programROM[0x8000] = {};
+};
+
+struct Harness : ares::Platform {
+  auto attach(ares::Node::Object node) -> void override {
+    if(auto midi = node->cast<ares::Node::Audio::MIDI>()) midi->setScheduler(scheduler);
+  }
+
+  auto midi(ares::Node::Audio::MIDI node) -> void override {
+    frequency = node->frequency();
+    for(auto& event : node->events()) events.append(event);
+  }
+
+  //returns the most bits per second sent within any one window of the given length, using running status.
+  auto peak(f64 window) const -> u64 {
+    u64 peak = 0, bytes = 0, bucket = 0;
+    u8 runningStatus = 0;
+    for(auto& event : events) {
+      if(event.timestamp / (frequency * window) != bucket) {
+        bucket = event.timestamp / (frequency * window);
+        bytes = 0;
+      }
+      u8 status = event.message;
+      if(status != runningStatus) bytes++;
+      runningStatus = status;
+      bytes += (status & 0xe0) == 0xc0 ? 1 : 2;
+      peak = max(peak, bytes);
+    }
+    return peak * 10 / window;
+  }
+
+  bool scheduler = false;
+  vector<MIDIEvent> events;
+  f64 frequency = 1.0;
+};
+
+static auto format(const MIDIEvent& event) -> string {
+  return {event.timestamp, " ", event.track, " ", hex(event.message, 6L)};
+}
+
+static auto load(const string& filename, vector<Write>& writes, Board& board) -> bool {
+  if(!file::exists(filename)) return false;
+  u32 number = 0;
+  for(auto line : string::read(filename).split("\n")) {
+    number++;
+    if(auto comment = line.find("#")) line.resize(*comment);
+    auto fields = line.strip().split(" ").strip();
+    fields.removeByValue("");
+    if(!fields) continue;
+    if(fields[0] == "prg" && fields.size() == 3) {
+      u32 address = fields[1].hex();
+      auto& bytes = fields[2];
+      for(u32 n = 0; n + 1 < bytes.size(); n += 2) {
+        board.programROM[(address + n / 2) & 0x7fff] = string{bytes.slice(n, 2)}.hex();
+      }
+      continue;
+    }
+    if(fields.size() == 3) {
+      writes.append({fields[0].natural(), (u16)fields[1].hex(), (u8)fields[2].hex()});
+      continue;
+    }
+    print("error: ", filename, ":", number, ": unrecognized entry\n");
+    return false;
+  }
+  return true;
+}
+
+auto nall::main(Arguments arguments) -> void {
+  Harness harness;
+  string golden;
+  arguments.take("--golden", golden);
+  bool update = arguments.take("--update");
+  harness.scheduler = arguments.take("--scheduler");
+  string filename = arguments.take();
+  if(!filename) {
+    print("usage: fc-midi log.txt [--scheduler] [--golden golden.txt [--update]]\n");
+    return;
+  }
+
+  if(!Famicom::APU::DMC::database().size()) {
+    print("error: unable to read dmc.db\n");
+    exit(EXIT_FAILURE);
+  }
+
+  ares::platform = &harness;
+  auto board = new Board;
+  vector<Write> writes;
+  cartridge.board = board;
+  if(!load(filename, writes, *board)) {
+    print("error: unable to read ", filename, "\n");
+    return;
+  }
+  writes.sort([](const Write& lhs, const Write& rhs) { return lhs.cycle < rhs.cycle; });
+
+  auto root = ares::Node::Object::create();
+  apu.load(root);
+  apu.power(false);
+
+  //services the DMC sample fetches that the CPU would otherwise perform:
+  auto step = [&] {
+    apu.main();
+    if(cpu.io.dmcDMAPending) {
+      cpu.io.dmcDMAPending = 0;
+      apu.dmc.setDMABuffer(cpu.readDebugger(apu.dmc.dmaAddress()));
+    }
+    if(apu.midiCycle % FrameCycles == 0) {
+      apu.midiFrame();
+      //as Scheduler::exit() would, rebase the clock before it can overflow:
+      u64 reduce = apu.clock();
+      apu.setClock(0);
+      apu.rebase(reduce);
+    }
+  };
+
+  u64 cycles = writes ? writes.last().cycle + FrameCycles : 0;
+  u64 start = chrono::nanosecond();
+  for(auto& write : writes) {
+    while(apu.midiCycle < write.cycle) step();
+    apu.writeIO(write.address, write.data);
+  }
+  while(apu.midiCycle < cycles) step();
+  apu.midiFrame();
+  f64 elapsed = max(1ull, chrono::nanosecond() - start) / 1'000'000'000.0;
+
+  f64 seconds = (f64)cycles / harness.frequency;
+  f64 frameSeconds = (f64)FrameCycles / harness.frequency;
+  print("writes:     ", writes.size(), "\n");
+  print("cycles:     ", cycles, " (", seconds, "s emulated)\n");
+  print("cycles/s:   ", u64(cycles / elapsed), "\n");
+  print("messages:   ", harness.events.size(), "\n");
+  print("messages/s: ", u64(harness.events.size() / elapsed), " (", u64(harness.events.size() / max(seconds, 1e-9)), " per emulated second)\n");
+  u64 peak = harness.peak(frameSeconds);
+  print("peak bps:   ", peak, " (", peak * 100 / ares::Core::Audio::MIDI::Baud, "% of the link, busiest frame)\n");
+  auto& telemetry = apu.midi->telemetry();
+  print("by type:    ", telemetry.noteOn, " note on, ", telemetry.noteOff, " note off, ", telemetry.controlChange, " control, ",
+    telemetry.programChange, " program, ", telemetry.pitchBend, " pitch bend, ", telemetry.other, " other\n");
+  print("suppressed: ", telemetry.dropped, " dropped, ", telemetry.coalesced, " coalesced, ", telemetry.stalls, " rate limit stalls\n");
+  print("DMC:        ", telemetry.cacheMisses, " cache misses, ", telemetry.sampleMisses, " unrecognized samples\n");
+
+  apu.unload();
+  cartridge.board.reset();
+  ares::platform = nullptr;
+
+  if(!golden) return;
+  if(update) {
+    string output;
+    for(auto& event : harness.events) output.append(format(event), "\n");
+    if(!file::write(golden, output)) print("error: unable to write ", golden, "\n");
+    return;
+  }
+
+  auto expected = string::read(golden).split("\n");
+  expected.removeByValue("");
+  u32 mismatches = 0;
+  for(u32 n : range(max(expected.size(), harness.events.size()))) {
+    string want = n < expected.size() ? expected[n] : string{"(none)"};
+    string have = n < harness.events.size() ? format(harness.events[n]) : string{"(none)"};
+    if(want == have) continue;
+    if(mismatches++ < 10) print("event ", n, ": expected ", want, ", got ", have, "\n");
+  }
+  if(mismatches) {
+    print("FAIL: ", mismatches, " events differ from ", golden, "\n");
+    exit(EXIT_FAILURE);
+  }
+  print("PASS: ", harness.events.size(), " events match ", golden, "\n");
+}
@@ -0,0 +1,255 @@
+#include <nall/nall.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <n64/n64.hpp>
+
+//draws a fixed list of RDP commands with the software renderer (RDP::Software) into a 64x64 frame buffer,
+//with 1, 2, 3 and 8 drawing threads, and checks that the frame and Z buffers are identical every time,
+//and identical to those this test was written against (Golden), so that changes to the output are noticed.
+//the list covers fill, copy, 1-cycle and 2-cycle modes, shaded, textured and Z buffered triangles, and the queue
+//being drawn at each point it must be: at Sync_Full, before a TMEM load reads RDRAM that queued primitives write,
+//and before the RDP is serialized.
+//eg: n64-rdp
+
+namespace N64 = ares::Nintendo64;
+using N64::rdp;
+using N64::rdram;
+
+static constexpr u32 Width = 64;
+static constexpr u32 FrameBuffer = 0x100000;
+static constexpr u32 DepthBuffer = 0x200000;
+static constexpr u32 Texture = 0x300000;
+static constexpr u32 Scratch = 0x380000;  //drawn to, then loaded into TMEM
+
+//FNV-64a of the frame and Z buffers drawn with one thread
+static constexpr u64 Golden = 0xd1ec0c8f0fe6ca82ull;
+
+static constexpr u32 ThreadCounts[] = {1, 2, 3, 8};
+
+struct Commands {
+  auto operator()(u64 command, u64 data) -> void { list.append(command << 56 | data); }
+  auto word(u64 data) -> void { list.append(data); }
+
+  //stores the commands in RDRAM and runs them; with sync, Sync_Full ends them.
+  auto run(bool sync = true) -> void {
+    if(sync) operator()(0x29, 0);
+    for(u32 n : range(list.size())) rdram.ram.write<N64::Dual>(0x1000 + n * 8, list[n], nullptr);
+    rdp.command.source = 0;
+    rdp.command.start = rdp.command.current = 0x1000;
+    rdp.command.end = 0x1000 + list.size() * 8;
+    rdp.render();
+    list.reset();
+  }
+
+  vector<u64> list;
+};
+
+static auto fixed(f64 value) -> u64 { return (u32)(s32)(value * 65536.0); }
+
+static auto pixel(u32 x, u32 y) -> u16 {
+  return rdram.ram.read<N64::Half>(FrameBuffer + (y * Width + x) * 2, nullptr);
+}
+
+struct Test {
+  auto expect(const char* what, u32 x, u32 y, u16 expected) -> void {
+    u16 actual = pixel(x, y);
+    if(actual == expected) return;
+    print(threads, " threads: ", what, " pixel (", x, ",", y, ") is ", hex(actual, 4L), ", not ", hex(expected, 4L), "\n");
+    failures++;
+  }
+
+  auto colorImage(u32 address) -> void {
+    op(0x3f, 0ull << 53 | 2ull << 51 | (u64)(Width - 1) << 32 | address);
+  }
+
+  auto fillRectangle(u32 x0, u32 y0, u32 x1, u32 y1) -> void {
+    op(0x36, (u64)(x1 * 4) << 44 | (u64)(y1 * 4) << 32 | (u64)(x0 * 4) << 12 | y0 * 4);
+  }
+
+  //a 16-bit 8x8 texture at address, loaded into tile 0 at TMEM address 0
+  auto loadTexture(u32 address, u32 width) -> void {
+    op(0x3d, 0ull << 53 | 2ull << 51 | (u64)(width - 1) << 32 | address);
+    op(0x35, 0ull << 53 | 2ull << 51 | 2ull << 41 | 0ull << 32 | 7ull << 24);
+    op(0x34, 0ull << 44 | 0ull << 32 | 7ull << 24 | 7ull * 4 << 12 | 7 * 4);
+    op(0x35, 0ull << 53 | 2ull << 51 | 2ull << 41 | 0ull << 32 | 0ull << 24);
+    op(0x32, 0ull << 44 | 0ull << 32 | 0ull << 24 | 7ull * 4 << 12 | 7 * 4);
+  }
+
+  //copies the 8x8 texture in tile 0 to (x, y)
+  auto copyRectangle(u32 x, u32 y) -> void {
+    op(0x2f, 2ull << 52);
+    op(0x24, (u64)((x + 7) * 4) << 44 | (u64)((y + 7) * 4) << 32 | 0ull << 24 | (u64)(x * 4) << 12 | y * 4);
+    op.word(0ull << 48 | 0ull << 32 | (u64)(4 << 10) << 16 | 1 << 10);
+  }
+
+  auto draw() -> void {
+    //clear the frame and Z buffers
+    op(0x3e, DepthBuffer);
+    op(0x2d, 0ull << 44 | 0ull << 32 | (u64)(Width * 4) << 12 | Width * 4);
+    op(0x2f, 3ull << 52);
+    colorImage(DepthBuffer);
+    op(0x37, 0xfffcfffc);
+    fillRectangle(0, 0, Width - 1, Width - 1);
+    colorImage(FrameBuffer);
+    op(0x37, 0x00030003);
+    fillRectangle(0, 0, Width - 1, Width - 1);
+    op.run();
+    expect("fill", 0, 0, 0x0003);
+    expect("fill", 63, 63, 0x0003);
+
+    //a 1-cycle triangle in the shade color, with its top at (8,8) and its bottom edge from (8,40) to (40,40)
+    op(0x2f, 0ull << 52);
+    op(0x3c, 15ull << 52 | 31ull << 47 | 7ull << 44 | 7ull << 41 | 15ull << 37 | 31ull << 32 | 15ull << 28 | 15ull << 24 | 7ull << 21 | 7ull << 18 | 4ull << 15 | 7ull << 12 | 4ull << 9 | 4ull << 6 | 7ull << 3 | 4ull);
+    op(0x0c, 1ull << 55 | (u64)(40 * 4) << 32 | (u64)(40 * 4) << 16 | 8 * 4);
+    op.word(fixed(40) << 32 | fixed(0));  //XL, DxLDy
+    op.word(fixed(8) << 32 | fixed(0));   //XH, DxHDy
+    op.word(fixed(8) << 32 | fixed(1));   //XM, DxMDy
+    op.word(255ull << 48 | 0ull << 32 | 0ull << 16 | 255);  //red
+    for(u32 n : range(7)) op.word(0);
+    op.run();
+    expect("triangle inside", 10, 30, 0xf801);
+    expect("triangle outside", 30, 10, 0x0003);
+    expect("triangle below", 10, 41, 0x0003);
+
+    //copy an 8x8 texture
+    for(u32 n : range(64)) rdram.ram.write<N64::Half>(Texture + n * 2, n * 0x0101 | 1, nullptr);
+    loadTexture(Texture, 8);
+    copyRectangle(48, 8);
+    op.run();
+    for(u32 y : range(8)) for(u32 x : range(8)) expect("copy", 48 + x, 8 + y, (y * 8 + x) * 0x0101 | 1);
+
+    //a far red square drawn after a near green one that overlaps it
+    op(0x2f, 0ull << 52 | 1ull << 5 | 1ull << 4);  //Z compare, Z update
+    square(20, 44, 12, 0ull << 48 | 255ull << 32 | 0ull << 16 | 255, 100.0);
+    square(24, 48, 12, 255ull << 48 | 0ull << 32 | 0ull << 16 | 255, 200.0);
+    op.run();
+    expect("Z near", 28, 52, 0x07c1);
+    expect("Z far", 34, 58, 0xf801);
+
+    //a texture drawn by the RDP, then loaded into TMEM before Sync_Full:
+    //the fill must be drawn before the load reads it.
+    op(0x2f, 3ull << 52);
+    colorImage(Scratch);
+    op(0x37, 0x003f003f);
+    fillRectangle(0, 0, 7, 7);
+    colorImage(FrameBuffer);
+    loadTexture(Scratch, Width);
+    copyRectangle(48, 24);
+    op.run();
+    expect("drawn texture", 48, 24, 0x003f);
+    expect("drawn texture", 55, 31, 0x003f);
+
+    //random triangles: 2-cycle, bilinear filtering, perspective correction and Z buffered
+    for(u32 n : range(64)) rdram.ram.write<N64::Half>(Texture + n * 2, n * 0x0421 | 1, nullptr);
+    loadTexture(Texture, 8);
+    op(0x35, 0ull << 53 | 2ull << 51 | 2ull << 41 | 0ull << 32 | 1ull << 24 | 1ull << 18 | 3ull << 14 | 1ull << 8 | 3ull << 4);
+    op(0x2f, 1ull << 52 | 1ull << 51 | 1ull << 45 | 0ull << 30 | 1ull << 14 | 1ull << 5 | 1ull << 4);
+    op(0x3c, 1ull << 52 | 4ull << 47 | 1ull << 44 | 4ull << 41 | 2ull << 37 | 4ull << 32 | 15ull << 28 | 0ull << 24 | 2ull << 21 | 4ull << 18 | 7ull << 15 | 7ull << 12 | 7ull << 9 | 1ull << 6 | 7ull << 3 | 7ull);
+    u32 seed = 1;
+    auto random = [&](u32 range) { seed = seed * 1103515245 + 12345; return (seed >> 8) % range; };
+    for(u32 n : range(300)) {
+      u32 yh = random(60 * 4), ym = yh + random(40), yl = ym + random(60);
+      op(0x0f, (u64)random(2) << 55 | (u64)(yl & 0x3fff) << 32 | (u64)(ym & 0x3fff) << 16 | yh);
+      f64 x = random(64);
+      op.word(fixed(x + random(20) - 10.0) << 32 | fixed((random(400) - 200) / 100.0));
+      op.word(fixed(x) << 32 | fixed((random(400) - 200) / 100.0));
+      op.word(fixed(x) << 32 | fixed((random(400) - 200) / 100.0));
+      //shade
+      op.word((u64)random(256) << 48 | (u64)random(256) << 32 | (u64)random(256) << 16 | random(256));
+      op.word((u64)random(8) << 48 | (u64)random(8) << 32 | (u64)random(8) << 16 | random(8));
+      op.word((u64)random(65536) << 48 | (u64)random(65536) << 32 | (u64)random(65536) << 16 | random(65536));
+      op.word((u64)random(65536) << 48 | (u64)random(65536) << 32 | (u64)random(65536) << 16 | random(65536));
+      for(u32 n : range(4)) op.word(0);
+      //texture: s, t and w
+      op.word((u64)random(1024) << 48 | (u64)random(1024) << 32 | (u64)0x7fff << 16);
+      op.word((u64)random(64) << 48 | (u64)random(64) << 32);
+      for(u32 n : range(6)) op.word(0);
+      //Z
+      op.word(fixed(random(30000)) << 32 | fixed(random(100)));
+      op.word(fixed(random(100)) << 32);
+      if(n % 50 == 49) op.run();
+    }
+    op.run();
+
+    //a rectangle still queued when the RDP is serialized
+    op(0x2f, 3ull << 52);
+    op(0x37, 0x07c107c1);
+    fillRectangle(0, 0, 3, 3);
+    op.run(false);
+    serializer s;
+    rdp.serialize(s);
+    expect("serialized", 0, 0, 0x07c1);
+    expect("serialized", 3, 3, 0x07c1);
+    op.run();
+  }
+
+  auto square(u32 x0, u32 y0, u32 size, u64 color, f64 z) -> void {
+    op(0x0d, 1ull << 55 | (u64)((y0 + size) * 4) << 32 | (u64)((y0 + size) * 4) << 16 | y0 * 4);
+    op.word(fixed(x0 + size) << 32 | fixed(0));
+    op.word(fixed(x0) << 32 | fixed(0));
+    op.word(fixed(x0 + size) << 32 | fixed(0));
+    op.word(color);
+    for(u32 n : range(7)) op.word(0);
+    op.word(fixed(z) << 32);
+    op.word(0);
+  }
+
+  //returns the FNV-64a hash of the frame and Z buffers
+  auto hash() -> u64 {
+    u64 hash = 14695981039346656037ull;
+    for(u32 address : {FrameBuffer, DepthBuffer}) {
+      for(u32 n : range(Width * Width * 2)) hash = (hash ^ rdram.ram.read<N64::Byte>(address + n, nullptr)) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  Commands op;
+  u32 threads = 1;
+  u32 failures = 0;
+};
+
+auto nall::main(Arguments arguments) -> void {
+  ares::Platform platform;
+  ares::platform = &platform;
+  auto root = ares::Node::Object::create();
+  rdp.load(root);
+  N64::mi.load(root);
+  rdram.ram.allocate(4_MiB);
+
+  u32 failures = 0;
+  u64 expected = Golden;
+  print("threads  hash\n");
+  for(u32 threads : ThreadCounts) {
+    Test test;
+    test.threads = threads;
+    rdram.ram.fill(0);
+    rdp.power(false);
+    rdp.software.setThreads(threads);
+    test.draw();
+    u64 hash = test.hash();
+    print(pad(threads, 7), "  ", hex(hash, 16L), "\n");
+    if(threads == 1 && hash != Golden) {
+      print("the image differs from the one this test was written against (", hex(Golden, 16L), ")\n");
+      failures++;
+      expected = hash;
+    }
+    if(hash != expected) {
+      print("the image drawn with ", threads, " threads differs from the one drawn with 1\n");
+      failures++;
+    }
+    failures += test.failures;
+  }
+
+  rdp.unload();
+  N64::mi.unload();
+  rdram.ram.reset();
+  ares::platform = nullptr;
+
+  if(failures) {
+    print("FAIL\n");
+    exit(EXIT_FAILURE);
+  }
+  print("PASS\n");
+}
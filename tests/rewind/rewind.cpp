@@ -0,0 +1,117 @@
+#include <nall/nall.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <desktop-ui/program/rewind.hpp>
+
+//checks that every snapshot restored from the rewind history, whether stored as a keyframe or as a delta against one,
+//matches the state that was saved byte for byte, while snapshots are evicted, rewound and saved again in turn.
+//it also checks that the history holds at least as many snapshots as requested when every snapshot is stored whole,
+//and more than that when most are deltas.
+//eg: rewind --states 4000
+
+struct Random {
+  auto operator()(u32 range) -> u32 {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return (seed >> 33) % range;
+  }
+  u64 seed = 1;
+};
+
+struct Harness {
+  //produces the next state from the last: most change a few small regions, as a running game's state would;
+  //some change everywhere, so that deltas are not worth keeping, and some change in size.
+  auto next() -> vector<u8> {
+    auto state = states ? states.last() : vector<u8>{};
+    if(!state) state.resize(Size);
+    u32 kind = random(16);
+    if(kind == 0) {
+      for(auto& byte : state) byte = random(256);
+    } else if(kind == 1) {
+      state.resize(Size - 256 + random(512));
+    } else {
+      for(u32 region : range(1 + random(8))) {
+        u32 offset = random(state.size());
+        u32 length = min(1 + random(64), (u32)state.size() - offset);
+        for(u32 n : range(length)) state[offset + n] = random(256);
+      }
+    }
+    return state;
+  }
+
+  auto save() -> void {
+    states.append(next());
+    history.save(states.last().data(), states.last().size(), Length);
+    //snapshots the history no longer holds cannot be restored:
+    while(states.size() > history.size()) states.removeLeft(), evicted++;
+  }
+
+  //restores the most recent snapshot, and checks it against the state it was saved from.
+  auto load() -> bool {
+    auto snapshot = history.load();
+    auto expected = states.takeLast();
+    restored++;
+    if(snapshot.size() == expected.size() && memory::compare(snapshot.data(), expected.data(), expected.size()) == 0) return true;
+    if(failures++ < 10) print("snapshot ", restored, ": restored ", snapshot.size(), " bytes that differ from the ", expected.size(), " saved\n");
+    return false;
+  }
+
+  static constexpr u32 Size = 16_KiB;
+  static constexpr u32 Length = 64;
+
+  Random random;
+  RewindHistory history;
+  vector<vector<u8>> states;  //the states the history holds, oldest first
+  u64 restored = 0;
+  u64 evicted = 0;
+  u64 failures = 0;
+  u64 peak = 0;
+};
+
+auto nall::main(Arguments arguments) -> void {
+  u32 count = 5000;
+  if(string value; arguments.take("--states", value)) count = max(1u, value.natural());
+
+  //saves states, and every so often rewinds through some (or all) of them before playing on:
+  Harness harness;
+  for(u32 n : range(count)) {
+    harness.save();
+    harness.peak = max(harness.peak, (u64)harness.history.size());
+    if(harness.random(1024) == 0) {
+      u32 steps = harness.random(2) ? harness.history.size() : harness.random(harness.history.size() + 1);
+      while(steps-- && harness.history) harness.load();
+    }
+  }
+  u32 keyframes = 0;
+  for(auto& snapshot : harness.history.snapshots()) keyframes += snapshot.keyframe;
+  print("deltas:    ", harness.history.size(), " snapshots held (", keyframes, " keyframes), at most ", harness.peak,
+    "; ", harness.evicted, " evicted\n");
+  while(harness.history) harness.load();
+  print("restored:  ", harness.restored, " snapshots, ", harness.failures, " mismatched\n");
+
+  //when no snapshot can be stored as a delta, the history must still hold as many as requested:
+  Harness whole;
+  for(u32 n : range(Harness::Length * 4)) {
+    whole.states.append(vector<u8>{});
+    whole.states.last().resize(Harness::Size);
+    for(auto& byte : whole.states.last()) byte = whole.random(256);
+    whole.history.save(whole.states.last().data(), Harness::Size, Harness::Length);
+    while(whole.states.size() > whole.history.size()) whole.states.removeLeft();
+  }
+  u32 held = whole.history.size();
+  print("keyframes: ", held, " snapshots held, of ", Harness::Length, " requested\n");
+  while(whole.history) whole.load();
+
+  u64 failures = harness.failures + whole.failures;
+  if(held < Harness::Length) {
+    print("FAIL: the history holds fewer snapshots than requested when none are deltas\n");
+    failures++;
+  }
+  if(harness.peak <= Harness::Length) {
+    print("FAIL: the history holds no more snapshots with deltas than without\n");
+    failures++;
+  }
+  if(failures) exit(EXIT_FAILURE);
+  print("PASS\n");
+}
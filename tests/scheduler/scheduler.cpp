@@ -0,0 +1,122 @@
+#include <nall/nall.hpp>
+#include <nall/chrono.hpp>
+using namespace nall;
+
+#include <nall/main.hpp>
+
+#include <ares/ares.hpp>
+
+//measures Scheduler and Thread overhead for systems of 2 to 10 threads, with and without Scheduler::setCaching().
+//thread 0 plays the role of a main CPU: every clock it steps and calls Thread::synchronize().
+//the others play coprocessors and video/audio chips: they step in bursts of several clocks and synchronize with thread 0,
+//so that thread 0 calls Thread::synchronize() many times for each switch, as a real CPU does.
+//all threads run at slightly different frequencies, as is typical, so that their clocks interleave,
+//and the last coprocessor runs lazily behind thread 0 (see Thread::setDeadline()), as the Famicom APU does.
+//the cached horizon must not change which thread runs when: each system is run both ways, and the order in which
+//threads were switched to, and their clocks at the time, must match those of the linear scan exactly.
+//eg: scheduler --frames 120
+
+namespace ares::Benchmark {
+  #include <ares/inline.hpp>
+  Scheduler scheduler;
+}
+
+using namespace ares::Benchmark;
+
+static constexpr u32 FrameClocks = 50'000;
+static constexpr u32 MaximumThreads = 10;
+
+struct Component : Thread {
+  auto main() -> void {
+    if(!primary) {
+      step(1);
+      Thread::synchronize();
+      if(++clocks % FrameClocks == 0) scheduler.exit(ares::Event::Frame);
+    } else {
+      step(burst);
+      if(lazy) setDeadline(clock() + scalar() * burst * 4);
+      Thread::synchronize(*primary);
+    }
+    if(active != this) {
+      active = this, switches++;
+      trace = (trace ^ index) * 1099511628211ull;
+      trace = (trace ^ clock()) * 1099511628211ull;
+    }
+    steps++;
+  }
+
+  Component* primary = nullptr;  //null for the primary thread itself
+  u32 index = 0;
+  u32 burst = 1;
+  bool lazy = false;
+  u64 clocks = 0;
+
+  static inline Component* active = nullptr;
+  static inline u64 switches = 0;
+  static inline u64 steps = 0;
+  static inline u64 trace = 0;  //FNV-64a of the thread switched to, and its clock, at every switch
+};
+
+struct Result {
+  f64 seconds;
+  u64 switches;
+  u64 steps;
+  u64 trace;
+};
+
+static auto run(u32 threads, u32 frames, bool caching) -> Result {
+  Component components[MaximumThreads];
+  scheduler.reset();
+  scheduler.setCaching(caching);
+  for(u32 n : range(threads)) {
+    auto& component = components[n];
+    component.index = n;
+    if(n) component.primary = &components[0], component.burst = 8 + n * 4;
+    component.lazy = n > 1 && n == threads - 1;
+    component.create(1'000'000.0 + n * 7'919.0, {&Component::main, &component});
+  }
+  scheduler.power(components[0]);
+  Component::active = nullptr;
+  Component::switches = 0;
+  Component::steps = 0;
+  Component::trace = 14695981039346656037ull;
+
+  u64 start = chrono::nanosecond();
+  for(u32 frame : range(frames)) scheduler.enter();
+  f64 seconds = max(1ull, chrono::nanosecond() - start) / 1'000'000'000.0;
+
+  Result result{seconds, Component::switches, Component::steps, Component::trace};
+  for(u32 n : range(threads)) components[n].destroy();
+  return result;
+}
+
+auto nall::main(Arguments arguments) -> void {
+  ares::Platform platform;
+  ares::platform = &platform;
+  u32 frames = 60;
+  if(string value; arguments.take("--frames", value)) frames = max(1u, value.natural());
+
+  u32 mismatches = 0;
+  print("threads  mode     steps/s      switches/s   ps/step  order\n");
+  for(u32 threads : range(2, MaximumThreads + 1)) {
+    Result linear;
+    for(bool caching : {false, true}) {
+      auto result = run(threads, frames, caching);
+      if(!caching) linear = result;
+      bool match = result.steps == linear.steps && result.switches == linear.switches && result.trace == linear.trace;
+      if(!match) mismatches++;
+      print(pad(threads, 7), "  ", caching ? "cached " : "linear ", "  ",
+        pad(u64(result.steps / result.seconds), 11), "  ",
+        pad(u64(result.switches / result.seconds), 11), "  ",
+        pad(u64(result.seconds * 1'000'000'000'000.0 / max(1ull, result.steps)), 7), "  ",
+        caching ? (match ? "same" : "differs") : "", "\n");
+    }
+  }
+  ares::platform = nullptr;
+
+  if(mismatches) {
+    print("FAIL: ", mismatches, " systems ran their threads in a different order with the cached horizon\n");
+    exit(EXIT_FAILURE);
+  }
+  print("PASS\n");
+}
@@ -0,0 +1,26 @@
+#include <nall/nall.hpp>
+
+using namespace nall;
+
+#include <ares/fc/apu/dmc-database.hpp>
+
+#include <nall/main.hpp>
+auto nall::main(Arguments arguments) -> void {
+  if(arguments.size() != 2) {
+    return print("usage: dmc2db dmc.bml dmc.db - compile the Famicom DMC sample database\n");
+  }
+
+  string markupName = arguments.take();
+  string outputName = arguments.take();
+  if(!markupName.endsWith(".bml")) return print("error: arguments in incorrect order\n");
+
+  string markup = string::read(markupName);
+  if(!markup) return print("error: unable to read sample database\n");
+
+  auto image = DMCSampleDatabase::compile(markup);
+  if(!file::write(outputName, image)) return print("error: unable to write output file\n");
+
+  DMCSampleDatabase database;
+  if(!database.open(outputName)) return print("error: unable to verify output file\n");
+  print("compiled ", database.size(), " samples\n");
+}